@@ -0,0 +1,53 @@
+#include "HashMap.h"
+#include "bench.h"
+
+// DefaultTraits without hash_batch(), to compare against
+struct OneAtATimeTraits {
+    static unsigned hash(const std::uint64_t& val) {
+        return hashfu::DefaultTraits<std::uint64_t>::hash(val);
+    }
+    static bool equals(const std::uint64_t& a, const std::uint64_t& b) {
+        return a == b;
+    }
+};
+
+template <typename Traits>
+void run(const char* name, const std::vector<std::uint64_t>& keys) {
+    char label[64];
+
+    // the hashing alone, as done by for_each_hashed()
+    std::vector<unsigned> hashes(keys.size());
+    std::snprintf(label, sizeof(label), "%s hash", name);
+    bench::report(label, bench::ns_per_op(keys.size(), [&] {
+                      hashfu::HashTable<std::uint64_t, Traits> table;
+                      table.template for_each_hashed<Traits>(
+                          keys.data(), keys.size(),
+                          [&](std::size_t i, unsigned hash) {
+                              hashes[i] = hash;
+                          });
+                  }));
+    bench::do_not_optimize(hashes.data());
+
+    // inserts without reserving, so that the map rehashes as it grows
+    hashfu::HashMap<std::uint64_t, std::uint64_t, Traits> map;
+    std::snprintf(label, sizeof(label), "%s grow", name);
+    bench::report(label, bench::ns_per_op(keys.size(), [&] {
+                      for (auto key : keys) map.insert(key, key);
+                  }));
+
+    std::vector<typename decltype(map)::ConstIterator> found(keys.size());
+    std::snprintf(label, sizeof(label), "%s find_batch", name);
+    bench::report(label, bench::ns_per_op(keys.size(), [&] {
+                      std::as_const(map).find_batch(keys.data(), keys.size(),
+                                                    found.data());
+                  }));
+    bench::do_not_optimize(found.data());
+}
+
+int main(int argc, char** argv) {
+    auto n = bench::size_arg(argc, argv, 1u << 20);
+    auto keys = bench::random_keys(n);
+
+    run<OneAtATimeTraits>("hash()", keys);
+    run<hashfu::DefaultTraits<std::uint64_t>>("hash_batch()", keys);
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace bench {
+
+// Runs fn() once and returns the elapsed time per operation in nanoseconds.
+template <typename Fn>
+double ns_per_op(std::size_t ops, Fn fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() /
+           static_cast<double>(ops);
+}
+
+// Keeps the optimizer from throwing away a result we only compute to time.
+template <typename T>
+void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline std::vector<std::uint64_t> random_keys(std::size_t n,
+                                              std::uint64_t seed = 42) {
+    std::mt19937_64 rng(seed);
+    std::vector<std::uint64_t> keys(n);
+    for (auto& key : keys) key = rng();
+    return keys;
+}
+
+// First command line argument, if any, overrides the problem size.
+inline std::size_t size_arg(int argc, char** argv, std::size_t fallback) {
+    return argc > 1 ? std::strtoull(argv[1], nullptr, 10) : fallback;
+}
+
+inline void report(const char* name, double ns) {
+    std::printf("%-36s %8.2f ns/op\n", name, ns);
+}
+
+struct TraitsForU64 {
+    static unsigned hash(const std::uint64_t& val) {
+        return static_cast<unsigned>(val ^ (val >> 32));
+    }
+    static bool equals(const std::uint64_t& a, const std::uint64_t& b) {
+        return a == b;
+    }
+};
+}  // namespace bench
@@ -0,0 +1,48 @@
+#include <algorithm>
+#include <memory>
+
+#include "CoroLookup.h"
+#include "bench.h"
+
+using Table = hashfu::HashTable<std::uint64_t, bench::TraitsForU64>;
+
+int main(int argc, char** argv) {
+    auto n = bench::size_arg(argc, argv, 1u << 22);
+
+    auto keys = bench::random_keys(n);
+    Table table;
+    for (auto key : keys) table.insert(key);
+
+    // half of the probes hit, in an order unrelated to insertion
+    auto probes = bench::random_keys(n, 7);
+    for (std::size_t i = 0; i < n; i += 2) probes[i] = keys[i];
+    std::shuffle(probes.begin(), probes.end(), std::mt19937_64(1));
+
+    std::printf("%zu entries, %zu buckets of %zu bytes\n", table.size(),
+                table.capacity(), sizeof(std::uint64_t) + 8);
+
+    auto found = std::make_unique<bool[]>(n);
+
+    bench::report("find", bench::ns_per_op(n, [&] {
+                      for (std::size_t i = 0; i < n; ++i) {
+                          found[i] = table.contains(probes[i]);
+                      }
+                  }));
+    bench::do_not_optimize(found[n / 2]);
+
+    bench::report("contains_batch", bench::ns_per_op(n, [&] {
+                      table.contains_batch(probes.data(), n, found.get());
+                  }));
+    bench::do_not_optimize(found[n / 2]);
+
+    for (std::size_t width : {4, 8, 16, 32}) {
+        char name[64];
+        std::snprintf(name, sizeof(name), "CoroLookup::contains (width %zu)",
+                      width);
+        bench::report(name, bench::ns_per_op(n, [&] {
+                          hashfu::CoroLookup<Table>::contains(
+                              table, probes.data(), n, found.get(), width);
+                      }));
+        bench::do_not_optimize(found[n / 2]);
+    }
+}
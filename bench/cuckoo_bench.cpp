@@ -0,0 +1,55 @@
+#include "CuckooHashTable.h"
+#include "HashTable.h"
+#include "bench.h"
+
+template <typename Table>
+void run(const char* name, std::size_t n) {
+    char label[64];
+    auto keys = bench::random_keys(n * 2);
+
+    Table table;
+    table.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) table.insert(keys[i]);
+
+    std::snprintf(label, sizeof(label), "%s insert", name);
+    bench::report(label, bench::ns_per_op(n, [&] {
+                      Table grown;
+                      for (std::size_t i = 0; i < n; ++i) {
+                          grown.insert(keys[i]);
+                      }
+                      bench::do_not_optimize(grown.size());
+                  }));
+
+    std::snprintf(label, sizeof(label), "%s hit", name);
+    bench::report(label, bench::ns_per_op(n, [&] {
+                      std::size_t found = 0;
+                      for (std::size_t i = 0; i < n; ++i) {
+                          found += table.contains(keys[i]);
+                      }
+                      bench::do_not_optimize(found);
+                  }));
+
+    std::snprintf(label, sizeof(label), "%s miss", name);
+    bench::report(label, bench::ns_per_op(n, [&] {
+                      std::size_t found = 0;
+                      for (std::size_t i = n; i < 2 * n; ++i) {
+                          found += table.contains(keys[i]);
+                      }
+                      bench::do_not_optimize(found);
+                  }));
+
+    std::printf("%-36s %8.2f of %zu slots\n", "  load factor",
+                table.load_factor(), table.capacity());
+}
+
+int main(int argc, char** argv) {
+    using Cuckoo = hashfu::CuckooHashTable<std::uint64_t>;
+
+    // as many keys as fill the cuckoo table to its maximum load factor;
+    // the linear probing table holds them at its own, 60%
+    auto n = bench::size_arg(argc, argv, 1u << 20);
+    n = Cuckoo(n).capacity() * Cuckoo::load_factor_percent / 100;
+
+    run<hashfu::HashTable<std::uint64_t>>("linear probing", n);
+    run<Cuckoo>("cuckoo", n);
+}
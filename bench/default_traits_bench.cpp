@@ -0,0 +1,53 @@
+#include <functional>
+
+#include "HashMap.h"
+#include "bench.h"
+
+// what hand-written traits wrapping std::hash amount to for integers
+struct IdentityTraits {
+    static unsigned hash(const std::uint64_t& val) {
+        return static_cast<unsigned>(std::hash<std::uint64_t>{}(val));
+    }
+    static bool equals(const std::uint64_t& a, const std::uint64_t& b) {
+        return a == b;
+    }
+};
+
+template <typename Traits>
+void run(const char* name, const std::vector<std::uint64_t>& keys) {
+    char label[64];
+    hashfu::HashMap<std::uint64_t, std::uint64_t, Traits> map;
+
+    std::snprintf(label, sizeof(label), "%s insert", name);
+    bench::report(label, bench::ns_per_op(keys.size(), [&] {
+                      for (auto key : keys) map.insert(key, key);
+                  }));
+
+    std::uint64_t sum = 0;
+    std::snprintf(label, sizeof(label), "%s find", name);
+    bench::report(label, bench::ns_per_op(keys.size(), [&] {
+                      for (auto key : keys) sum += map.find(key)->value;
+                  }));
+    bench::do_not_optimize(sum);
+}
+
+int main(int argc, char** argv) {
+    auto n = bench::size_arg(argc, argv, 1u << 16);
+
+    std::vector<std::uint64_t> sequential(n), strided(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        sequential[i] = i;
+        // e.g. ids with a type tag in the low bits
+        strided[i] = i << 8;
+    }
+
+    run<IdentityTraits>("std::hash, sequential", sequential);
+    run<hashfu::DefaultTraits<std::uint64_t>>("DefaultTraits, sequential",
+                                              sequential);
+    run<IdentityTraits>("std::hash, strided", strided);
+    run<hashfu::DefaultTraits<std::uint64_t>>("DefaultTraits, strided",
+                                              strided);
+    run<IdentityTraits>("std::hash, random", bench::random_keys(n));
+    run<hashfu::DefaultTraits<std::uint64_t>>("DefaultTraits, random",
+                                              bench::random_keys(n));
+}
@@ -0,0 +1,65 @@
+#include "DenseHashMap.h"
+#include "HashMap.h"
+#include "bench.h"
+
+struct Value {
+    std::uint64_t words[8];
+};
+
+using Map = hashfu::HashMap<std::uint64_t, Value, bench::TraitsForU64>;
+using DenseMap =
+    hashfu::DenseHashMap<std::uint64_t, Value, bench::TraitsForU64>;
+
+template <typename MapType>
+void iterate(const char* label, const MapType& map) {
+    std::uint64_t sum = 0;
+    bench::report(label, bench::ns_per_op(map.size(), [&] {
+                      for (const auto& entry : map) sum += entry.value.words[0];
+                  }));
+    bench::do_not_optimize(sum);
+}
+
+template <typename MapType>
+void run(const char* name, const std::vector<std::uint64_t>& keys) {
+    char label[64];
+    Value value{};
+
+    MapType map;
+    for (auto key : keys) {
+        value.words[0] = key;
+        map.insert(key, value);
+    }
+
+    std::snprintf(label, sizeof(label), "%s iterate", name);
+    iterate(label, map);
+
+    std::uint64_t sum = 0;
+    std::snprintf(label, sizeof(label), "%s find", name);
+    bench::report(label, bench::ns_per_op(keys.size(), [&] {
+                      for (auto key : keys) {
+                          sum += map.find(key)->value.words[0];
+                      }
+                  }));
+    bench::do_not_optimize(sum);
+
+    MapType rehashed = map;
+    std::snprintf(label, sizeof(label), "%s rehash (per entry)", name);
+    bench::report(label, bench::ns_per_op(map.size(), [&] {
+                      rehashed.reserve(rehashed.capacity() * 2);
+                  }));
+
+    // the probe table keeps its size after removals
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        if (i % 10 != 0) map.remove(keys[i]);
+    }
+    std::snprintf(label, sizeof(label), "%s iterate, 1/10 left", name);
+    iterate(label, map);
+}
+
+int main(int argc, char** argv) {
+    auto n = bench::size_arg(argc, argv, 1u << 20);
+    auto keys = bench::random_keys(n);
+
+    run<Map>("HashMap", keys);
+    run<DenseMap>("DenseHashMap", keys);
+}
@@ -0,0 +1,84 @@
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+#include "HashMap.h"
+#include "bench.h"
+
+/* Inserts keys picked to collide, the way a client sending crafted
+ * strings would, and reports the mean and worst insert latency. */
+
+// DefaultTraits without the seeded overload
+struct UnseededTraits {
+    static unsigned hash(const std::string& val) {
+        return hashfu::DefaultTraits<std::string>::hash(val);
+    }
+    static bool equals(const std::string& a, const std::string& b) {
+        return a == b;
+    }
+};
+
+// Tables grow by doubling from a power of two, so keys whose hashes share
+// their low `bits` bits pile up in a handful of buckets.
+template <typename HashFn>
+std::vector<std::string> colliding_keys(std::size_t n, unsigned bits,
+                                        HashFn hash) {
+    std::vector<std::string> keys;
+    for (std::uint64_t i = 0; keys.size() < n; ++i) {
+        auto key = "session-" + std::to_string(i);
+        if ((hash(key) & ((1u << bits) - 1)) == 0) keys.push_back(key);
+    }
+    return keys;
+}
+
+template <typename Map>
+void run(const char* name, Map& map, const std::vector<std::string>& keys) {
+    double worst = 0;
+    auto mean = bench::ns_per_op(keys.size(), [&] {
+        for (const auto& key : keys) {
+            auto start = std::chrono::steady_clock::now();
+            map.insert(key, 1);
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            worst = std::max(
+                worst,
+                std::chrono::duration<double, std::nano>(elapsed).count());
+        }
+    });
+
+    char label[64];
+    std::snprintf(label, sizeof(label), "%s mean", name);
+    bench::report(label, mean);
+    std::snprintf(label, sizeof(label), "%s worst", name);
+    bench::report(label, worst);
+}
+
+int main(int argc, char** argv) {
+    auto n = bench::size_arg(argc, argv, 4000);
+    constexpr unsigned bits = 12;
+
+    // the attacker knows the hash function
+    {
+        hashfu::HashMap<std::string, int, UnseededTraits> map;
+        run("unseeded", map,
+            colliding_keys(n, bits, [](const std::string& key) {
+                return UnseededTraits::hash(key);
+            }));
+    }
+    // the same keys against a seeded map
+    {
+        hashfu::HashMap<std::string, int> map;
+        run("seeded", map,
+            colliding_keys(n, bits, [](const std::string& key) {
+                return UnseededTraits::hash(key);
+            }));
+    }
+    // the attacker has even learned this map's seed; long probes make the
+    // map reseed, which scatters the keys again
+    {
+        hashfu::HashMap<std::string, int> map;
+        run("seeded, seed leaked", map,
+            colliding_keys(n, bits, [&map](const std::string& key) {
+                return map.hash_key(key);
+            }));
+    }
+}
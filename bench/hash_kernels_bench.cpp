@@ -0,0 +1,89 @@
+#include <string>
+
+#include "HashKernels.h"
+#include "HashMap.h"
+#include "bench.h"
+
+using hashfu::HashKernel;
+
+static const char* kernel_name(HashKernel kernel) {
+    switch (kernel) {
+        case HashKernel::Scalar:
+            return "scalar";
+        case HashKernel::Crc32c:
+            return "crc32c";
+        case HashKernel::Aes:
+            return "aes";
+        case HashKernel::Avx2:
+            return "avx2";
+    }
+    return "?";
+}
+
+int main(int argc, char** argv) {
+    auto total_bytes = bench::size_arg(argc, argv, std::size_t{1} << 28);
+
+    std::string data(4096, '\0');
+    auto random = bench::random_keys(data.size());
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<char>(random[i]);
+    }
+
+    char label[64];
+    for (auto kernel : {HashKernel::Scalar, HashKernel::Crc32c,
+                        HashKernel::Aes, HashKernel::Avx2}) {
+        if (!hashfu::hash_kernel_supported(kernel)) {
+            std::printf("%s: not supported by this CPU\n", kernel_name(kernel));
+            continue;
+        }
+
+        for (std::size_t len : {8u, 16u, 32u, 64u, 128u, 256u, 1024u, 4096u}) {
+            auto hashes = total_bytes / len;
+            std::uint64_t sum = 0;
+            auto ns = bench::ns_per_op(hashes, [&] {
+                for (std::size_t i = 0; i < hashes; ++i) {
+                    sum += hashfu::hash_bytes_with(kernel, data.data(), len,
+                                                   i);
+                }
+            });
+            bench::do_not_optimize(sum);
+
+            std::snprintf(label, sizeof(label), "%s %4zuB", kernel_name(kernel),
+                          len);
+            std::printf("%-36s %8.2f ns/op %8.2f GB/s\n", label, ns,
+                        static_cast<double>(len) / ns);
+        }
+    }
+
+    // end to end, with the kernel picked for this CPU; few enough keys to
+    // stay in cache, so the hash is a visible part of each lookup
+    std::printf("selected kernel: %s\n",
+                kernel_name(hashfu::selected_hash_kernel()));
+    std::vector<std::string> keys;
+    for (auto key : bench::random_keys(1u << 12)) {
+        keys.push_back("/usr/share/doc/packages/item/" + std::to_string(key));
+    }
+    hashfu::HashMap<std::string, int> default_map;
+    hashfu::HashMap<std::string, int, hashfu::AcceleratedTraits<std::string>>
+        accelerated_map;
+    for (const auto& key : keys) {
+        default_map.insert(key, 1);
+        accelerated_map.insert(key, 1);
+    }
+
+    constexpr int rounds = 64;
+    int found = 0;
+    bench::report("DefaultTraits find",
+                  bench::ns_per_op(keys.size() * rounds, [&] {
+                      for (int round = 0; round < rounds; ++round)
+                          for (const auto& key : keys)
+                              found += default_map.find(key)->value;
+                  }));
+    bench::report("AcceleratedTraits find",
+                  bench::ns_per_op(keys.size() * rounds, [&] {
+                      for (int round = 0; round < rounds; ++round)
+                          for (const auto& key : keys)
+                              found += accelerated_map.find(key)->value;
+                  }));
+    bench::do_not_optimize(found);
+}
@@ -0,0 +1,68 @@
+#include "CuckooHashTable.h"
+#include "HashMap.h"
+#include "HopscotchHashTable.h"
+#include "bench.h"
+
+template <typename T, typename Traits>
+using Hopscotch64 = hashfu::HopscotchHashTable<T, Traits, 64>;
+
+// HashMap over each table, holding `load` percent of `buckets` keys
+template <template <typename...> class Table>
+void run(const char* name, std::size_t buckets, std::size_t load) {
+    using Map = hashfu::HashMap<std::uint64_t, std::uint64_t,
+                                bench::TraitsForU64, Table>;
+    char label[64];
+    auto n = buckets * load / 100;
+    auto keys = bench::random_keys(n * 2);
+
+    Map map;
+    map.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) map.insert(keys[i], i);
+
+    std::snprintf(label, sizeof(label), "%s %zu%% insert", name, load);
+    bench::report(label, bench::ns_per_op(n, [&] {
+                      Map grown;
+                      grown.reserve(n);
+                      for (std::size_t i = 0; i < n; ++i) {
+                          grown.insert(keys[i], i);
+                      }
+                      bench::do_not_optimize(grown.size());
+                  }));
+
+    std::snprintf(label, sizeof(label), "%s %zu%% hit", name, load);
+    bench::report(label, bench::ns_per_op(n, [&] {
+                      std::uint64_t sum = 0;
+                      for (std::size_t i = 0; i < n; ++i) {
+                          sum += map.find(keys[i])->value;
+                      }
+                      bench::do_not_optimize(sum);
+                  }));
+
+    std::snprintf(label, sizeof(label), "%s %zu%% miss", name, load);
+    bench::report(label, bench::ns_per_op(n, [&] {
+                      std::size_t found = 0;
+                      for (std::size_t i = n; i < 2 * n; ++i) {
+                          found += map.contains(keys[i]);
+                      }
+                      bench::do_not_optimize(found);
+                  }));
+
+    std::printf("%-36s %8.2f of %zu slots\n", "  load factor",
+                map.load_factor(), map.capacity());
+}
+
+int main(int argc, char** argv) {
+    std::size_t buckets = 1;
+    while (buckets < bench::size_arg(argc, argv, 1u << 20)) buckets *= 2;
+
+    // linear probing can't go past 60%, so it holds the same keys in a
+    // larger table; H = 32 neighborhoods stop at 80%
+    for (std::size_t load : {80, 90}) {
+        run<hashfu::HashTable>("linear probing", buckets, load);
+        if (load <= 80) {
+            run<hashfu::HopscotchTable>("hopscotch/32", buckets, load);
+        }
+        run<Hopscotch64>("hopscotch/64", buckets, load);
+        run<hashfu::CuckooTable>("cuckoo", buckets, load);
+    }
+}
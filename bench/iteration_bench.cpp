@@ -0,0 +1,39 @@
+#include "HashTable.h"
+#include "bench.h"
+
+using Table = hashfu::HashTable<std::uint64_t, bench::TraitsForU64>;
+
+int main(int argc, char** argv) {
+    auto n = bench::size_arg(argc, argv, 1u << 20);
+
+    auto keys = bench::random_keys(n);
+    Table table;
+    for (auto key : keys) table.insert(key);
+
+    std::printf("%zu buckets\n", table.capacity());
+
+    for (std::size_t keep_every : {1, 10, 100, 1000}) {
+        // thin the table out to one entry in `keep_every`
+        Table sparse = table;
+        for (std::size_t i = 0; i < n; ++i) {
+            if (i % keep_every != 0) sparse.remove(keys[i]);
+        }
+
+        std::uint64_t sum = 0;
+        char name[64];
+        std::snprintf(name, sizeof(name), "iterate, 1/%zu full", keep_every);
+        bench::report(name, bench::ns_per_op(sparse.size(), [&] {
+                          for (auto key : sparse) sum += key;
+                      }));
+        bench::do_not_optimize(sum);
+    }
+
+    // drain the table through begin(), which used to rescan from slot 0
+    auto drained = std::min<std::size_t>(n, 1u << 16);
+    Table draining = table;
+    bench::report("remove(*begin())", bench::ns_per_op(drained, [&] {
+                      for (std::size_t i = 0; i < drained; ++i) {
+                          draining.remove(*draining.begin());
+                      }
+                  }));
+}
@@ -0,0 +1,51 @@
+#include "HashMap.h"
+#include "NodeHashMap.h"
+#include "bench.h"
+
+// large enough that moving entries dominates growing the table
+struct Big {
+    std::uint64_t words[32];
+};
+
+using Map = hashfu::HashMap<std::uint64_t, Big, bench::TraitsForU64>;
+using NodeMap = hashfu::NodeHashMap<std::uint64_t, Big, bench::TraitsForU64>;
+
+template <typename MapType>
+void run(const char* name, const std::vector<std::uint64_t>& keys) {
+    char label[64];
+    Big value{};
+
+    MapType map;
+    std::snprintf(label, sizeof(label), "%s insert", name);
+    bench::report(label, bench::ns_per_op(keys.size(), [&] {
+                      for (auto key : keys) {
+                          value.words[0] = key;
+                          map.insert(key, value);
+                      }
+                  }));
+
+    auto lookups = bench::random_keys(keys.size(), 7);
+    for (auto& key : lookups) key = keys[key % keys.size()];
+
+    std::uint64_t sum = 0;
+    std::snprintf(label, sizeof(label), "%s find", name);
+    bench::report(label, bench::ns_per_op(lookups.size(), [&] {
+                      for (auto key : lookups) {
+                          sum += map.find(key)->value.words[0];
+                      }
+                  }));
+    bench::do_not_optimize(sum);
+
+    std::snprintf(label, sizeof(label), "%s rehash (per entry)", name);
+    bench::report(label, bench::ns_per_op(map.size(), [&] {
+                      map.reserve(map.capacity() * 2);
+                  }));
+}
+
+int main(int argc, char** argv) {
+    auto n = bench::size_arg(argc, argv, 1u << 18);
+    auto keys = bench::random_keys(n);
+
+    run<Map>("HashMap", keys);
+    run<NodeMap>("NodeHashMap", keys);
+}
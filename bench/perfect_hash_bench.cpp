@@ -0,0 +1,43 @@
+#include <algorithm>
+
+#include "PerfectHash.h"
+#include "bench.h"
+
+using Map = hashfu::HashMap<std::uint64_t, std::uint64_t, bench::TraitsForU64>;
+using Perfect =
+    hashfu::PerfectHashMap<std::uint64_t, std::uint64_t, bench::TraitsForU64>;
+
+int main(int argc, char** argv) {
+    auto n = bench::size_arg(argc, argv, 1u << 20);
+    auto keys = bench::random_keys(n);
+
+    Map map;
+    bench::report("build HashMap (insert)", bench::ns_per_op(n, [&] {
+                      for (auto key : keys) map.insert(key, key);
+                  }));
+
+    Perfect perfect;
+    bench::report("build PerfectHashMap", bench::ns_per_op(n, [&] {
+                      if (!perfect.build(map)) std::abort();
+                  }));
+
+    hashfu::MinimalPerfectHash<std::uint64_t, bench::TraitsForU64> mph;
+    bench::report("build MinimalPerfectHash", bench::ns_per_op(n, [&] {
+                      if (!mph.build(keys.begin(), keys.end())) std::abort();
+                  }));
+
+    auto probes = keys;
+    std::shuffle(probes.begin(), probes.end(), std::mt19937_64(1));
+
+    std::uint64_t sum = 0;
+    bench::report("HashMap::find", bench::ns_per_op(n, [&] {
+                      for (auto key : probes) sum += map.find(key)->value;
+                  }));
+    bench::report("PerfectHashMap::find", bench::ns_per_op(n, [&] {
+                      for (auto key : probes) sum += *perfect.find(key);
+                  }));
+    bench::do_not_optimize(sum);
+
+    std::printf("HashMap: %zu buckets for %zu entries\n", map.capacity(),
+                map.size());
+}
@@ -0,0 +1,92 @@
+#include <array>
+#include <cstring>
+
+#include "HashMap.h"
+#include "SmallHashMap.h"
+#include "bench.h"
+
+struct Uuid {
+    std::uint64_t high, low;
+};
+using Digest = std::array<std::uint64_t, 4>;
+
+// What one would write by hand without DefaultTraits: combine the fields,
+// compare them one by one.
+struct FieldwiseUuidTraits {
+    static unsigned hash(const Uuid& id) {
+        return hashfu::DefaultTraits<std::uint64_t>::hash(id.high * 31 +
+                                                           id.low);
+    }
+    static bool equals(const Uuid& a, const Uuid& b) {
+        return a.high == b.high && a.low == b.low;
+    }
+};
+
+struct FieldwiseDigestTraits {
+    static unsigned hash(const Digest& d) {
+        std::uint64_t h = 0;
+        for (auto word : d) h = h * 31 + word;
+        return hashfu::DefaultTraits<std::uint64_t>::hash(h);
+    }
+    static bool equals(const Digest& a, const Digest& b) {
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            if (a[i] != b[i]) return false;
+        }
+        return true;
+    }
+};
+
+template <typename K>
+std::vector<K> random_pods(std::size_t n) {
+    auto words = bench::random_keys(n * sizeof(K) / 8);
+    std::vector<K> keys(n);
+    std::memcpy(keys.data(), words.data(), n * sizeof(K));
+    return keys;
+}
+
+template <typename K, typename Traits>
+void run(const char* name, const std::vector<K>& keys) {
+    char label[64];
+
+    hashfu::HashMap<K, std::uint32_t, Traits> map;
+    map.reserve(keys.size());
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        map.insert(keys[i], static_cast<std::uint32_t>(i));
+    }
+    std::snprintf(label, sizeof(label), "%s HashMap find", name);
+    bench::report(label, bench::ns_per_op(keys.size(), [&] {
+                      std::uint64_t sum = 0;
+                      for (const auto& key : keys) sum += map.find(key)->value;
+                      bench::do_not_optimize(sum);
+                  }));
+
+    // inline maps scanned without hashing
+    constexpr std::size_t inline_keys = 8;
+    hashfu::SmallHashMap<K, std::uint32_t, Traits, inline_keys> small;
+    for (std::size_t i = 0; i < inline_keys; ++i) {
+        small.insert(keys[i], static_cast<std::uint32_t>(i));
+    }
+    constexpr std::size_t rounds = 1 << 17;
+    std::snprintf(label, sizeof(label), "%s SmallHashMap find", name);
+    bench::report(label, bench::ns_per_op(rounds * inline_keys, [&] {
+                      std::uint64_t sum = 0;
+                      for (std::size_t r = 0; r < rounds; ++r) {
+                          for (std::size_t i = 0; i < inline_keys; ++i) {
+                              sum += *small.find(keys[i]);
+                          }
+                      }
+                      bench::do_not_optimize(sum);
+                  }));
+}
+
+int main(int argc, char** argv) {
+    auto n = bench::size_arg(argc, argv, 1u << 16);
+
+    auto uuids = random_pods<Uuid>(n);
+    run<Uuid, FieldwiseUuidTraits>("uuid fieldwise", uuids);
+    run<Uuid, hashfu::DefaultTraits<Uuid>>("uuid default", uuids);
+
+    auto digests = random_pods<Digest>(n);
+    run<Digest, FieldwiseDigestTraits>("digest fieldwise", digests);
+    run<Digest, hashfu::DefaultTraits<Digest>>("digest default", digests);
+}
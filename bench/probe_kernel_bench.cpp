@@ -0,0 +1,57 @@
+#include "HashTable.h"
+#include "bench.h"
+
+// DefaultTraits without bitwise_equals, which keeps lookups on the plain
+// probe loop
+template <typename I>
+struct PlainProbeTraits {
+    static unsigned hash(const I& val) {
+        return hashfu::DefaultTraits<I>::hash(val);
+    }
+    static bool equals(const I& a, const I& b) { return a == b; }
+};
+
+template <typename I, typename Traits>
+void run(const char* name, std::size_t n) {
+    char label[64];
+
+    // filled right up to the load factor, where probes are longest
+    hashfu::HashTable<I, Traits> table;
+    table.reserve(n);
+    auto keys = bench::random_keys(n * 2);
+    for (std::size_t i = 0; i < n; ++i) table.insert(static_cast<I>(keys[i]));
+
+    constexpr std::size_t rounds = 8;
+    std::snprintf(label, sizeof(label), "%s hit", name);
+    bench::report(label, bench::ns_per_op(n * rounds, [&] {
+                      std::size_t found = 0;
+                      for (std::size_t r = 0; r < rounds; ++r) {
+                          for (std::size_t i = 0; i < n; ++i) {
+                              found += table.contains(static_cast<I>(keys[i]));
+                          }
+                      }
+                      bench::do_not_optimize(found);
+                  }));
+
+    std::snprintf(label, sizeof(label), "%s miss", name);
+    bench::report(label, bench::ns_per_op(n * rounds, [&] {
+                      std::size_t found = 0;
+                      for (std::size_t r = 0; r < rounds; ++r) {
+                          for (std::size_t i = n; i < 2 * n; ++i) {
+                              found += table.contains(static_cast<I>(keys[i]));
+                          }
+                      }
+                      bench::do_not_optimize(found);
+                  }));
+}
+
+int main(int argc, char** argv) {
+    // small enough by default for the table to stay in cache, so that the
+    // probes themselves are what is timed
+    auto n = bench::size_arg(argc, argv, 1u << 14);
+
+    run<std::uint32_t, PlainProbeTraits<std::uint32_t>>("u32 plain", n);
+    run<std::uint32_t, hashfu::DefaultTraits<std::uint32_t>>("u32 simd", n);
+    run<std::uint64_t, PlainProbeTraits<std::uint64_t>>("u64 plain", n);
+    run<std::uint64_t, hashfu::DefaultTraits<std::uint64_t>>("u64 simd", n);
+}
@@ -0,0 +1,48 @@
+#include "HashMap.h"
+#include "SmallHashMap.h"
+#include "bench.h"
+
+struct Traits : bench::TraitsForU64 {
+    static constexpr bool bitwise_equals = true;
+};
+
+using Map = hashfu::HashMap<std::uint64_t, std::uint64_t, Traits>;
+using SmallMap = hashfu::SmallHashMap<std::uint64_t, std::uint64_t, Traits, 16>;
+
+// Builds a map of `size` entries per round, like a per-request map would,
+// and looks every key up four times.
+template <typename MapType>
+double build_and_query(const std::vector<std::uint64_t>& keys,
+                       std::size_t size, std::size_t rounds) {
+    std::uint64_t sum = 0;
+    auto ns = bench::ns_per_op(rounds, [&] {
+        for (std::size_t r = 0; r < rounds; ++r) {
+            const auto* round_keys = &keys[(r * size) % (keys.size() - size)];
+
+            MapType map;
+            for (std::size_t i = 0; i < size; ++i) {
+                map.insert(round_keys[i], i);
+            }
+            for (int pass = 0; pass < 4; ++pass) {
+                for (std::size_t i = 0; i < size; ++i) {
+                    sum += map.contains(round_keys[i]);
+                }
+            }
+        }
+    });
+    bench::do_not_optimize(sum);
+    return ns;
+}
+
+int main(int argc, char** argv) {
+    auto rounds = bench::size_arg(argc, argv, 1u << 18);
+    auto keys = bench::random_keys(1u << 16);
+
+    for (std::size_t size : {1, 4, 8, 16}) {
+        char label[64];
+        std::snprintf(label, sizeof(label), "HashMap, %zu entries", size);
+        bench::report(label, build_and_query<Map>(keys, size, rounds));
+        std::snprintf(label, sizeof(label), "SmallHashMap, %zu entries", size);
+        bench::report(label, build_and_query<SmallMap>(keys, size, rounds));
+    }
+}
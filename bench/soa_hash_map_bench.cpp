@@ -0,0 +1,59 @@
+#include "HashMap.h"
+#include "SoAHashMap.h"
+#include "bench.h"
+
+template <std::size_t Size>
+struct Value {
+    std::uint64_t words[Size / 8];
+};
+
+template <typename MapType>
+void run(const char* name, const std::vector<std::uint64_t>& keys,
+         const std::vector<std::uint64_t>& missing) {
+    using V = std::remove_reference_t<decltype(MapType()[0])>;
+    char label[64];
+
+    MapType map;
+    V value{};
+    for (auto key : keys) {
+        value.words[0] = key;
+        map.insert(key, value);
+    }
+
+    std::uint64_t sum = 0;
+    std::snprintf(label, sizeof(label), "%s find hit", name);
+    bench::report(label, bench::ns_per_op(keys.size(), [&] {
+                      for (auto key : keys) {
+                          sum += map.find(key)->value.words[0];
+                      }
+                  }));
+
+    std::snprintf(label, sizeof(label), "%s find miss", name);
+    bench::report(label, bench::ns_per_op(missing.size(), [&] {
+                      for (auto key : missing) sum += map.contains(key);
+                  }));
+    bench::do_not_optimize(sum);
+}
+
+template <std::size_t Size>
+void run_size(const std::vector<std::uint64_t>& keys,
+              const std::vector<std::uint64_t>& missing) {
+    using Traits = bench::TraitsForU64;
+    char name[64];
+
+    std::snprintf(name, sizeof(name), "HashMap<8B, %zuB>", Size);
+    run<hashfu::HashMap<std::uint64_t, Value<Size>, Traits>>(name, keys,
+                                                              missing);
+    std::snprintf(name, sizeof(name), "SoAHashMap<8B, %zuB>", Size);
+    run<hashfu::SoAHashMap<std::uint64_t, Value<Size>, Traits>>(name, keys,
+                                                                 missing);
+}
+
+int main(int argc, char** argv) {
+    auto n = bench::size_arg(argc, argv, 1u << 18);
+    auto keys = bench::random_keys(n);
+    auto missing = bench::random_keys(n, 7);
+
+    run_size<64>(keys, missing);
+    run_size<256>(keys, missing);
+}
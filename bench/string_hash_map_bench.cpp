@@ -0,0 +1,73 @@
+#include <malloc.h>
+
+#include <string>
+#include <string_view>
+
+#include "ConstexprHashMap.h"
+#include "HashMap.h"
+#include "StringHashMap.h"
+#include "bench.h"
+
+using hashfu::StringViewTraits;
+
+struct TraitsForString {
+    static unsigned hash(const std::string& val) {
+        return StringViewTraits::hash(val);
+    }
+    static bool equals(const std::string& a, const std::string& b) {
+        return a == b;
+    }
+};
+
+using Map = hashfu::HashMap<std::string, int, TraitsForString>;
+using StringMap = hashfu::StringHashMap<int, StringViewTraits>;
+
+// bytes of heap in use, as glibc's malloc sees it
+std::size_t heap_in_use() { return mallinfo2().uordblks; }
+
+// 24 characters each, too long for std::string's inline buffer
+std::vector<std::string> make_keys(std::size_t n) {
+    std::vector<std::string> keys;
+    keys.reserve(n);
+    for (auto value : bench::random_keys(n)) {
+        char key[32];
+        std::snprintf(key, sizeof(key), "session/%016llx",
+                      static_cast<unsigned long long>(value));
+        keys.emplace_back(key);
+    }
+    return keys;
+}
+
+template <typename MapType>
+void run(const char* name, const std::vector<std::string>& keys) {
+    char label[64];
+    auto heap_before = heap_in_use();
+
+    MapType map;
+    std::snprintf(label, sizeof(label), "%s insert", name);
+    bench::report(label, bench::ns_per_op(keys.size(), [&] {
+                      for (std::size_t i = 0; i < keys.size(); ++i) {
+                          map.insert(keys[i], static_cast<int>(i));
+                      }
+                  }));
+
+    std::snprintf(label, sizeof(label), "%s heap", name);
+    std::printf("%-36s %8.1f MiB\n", label,
+                static_cast<double>(heap_in_use() - heap_before) /
+                    (1024 * 1024));
+
+    long sum = 0;
+    std::snprintf(label, sizeof(label), "%s find", name);
+    bench::report(label, bench::ns_per_op(keys.size(), [&] {
+                      for (const auto& key : keys) sum += map.find(key)->value;
+                  }));
+    bench::do_not_optimize(sum);
+}
+
+int main(int argc, char** argv) {
+    auto n = bench::size_arg(argc, argv, 1u << 21);
+    auto keys = make_keys(n);
+
+    run<Map>("HashMap<std::string>", keys);
+    run<StringMap>("StringHashMap", keys);
+}
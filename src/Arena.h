@@ -0,0 +1,85 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace hashfu {
+
+/* Bump allocator handing out memory from large blocks. Individual
+ * allocations are never freed, only everything at once by clear() or the
+ * destructor, and nothing allocated ever moves. */
+class Arena {
+    static constexpr std::size_t block_size = 64 * 1024;
+
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    char* cursor_{nullptr};
+    std::size_t remaining_{0};
+    std::size_t bytes_reserved_{0};
+
+   public:
+    Arena() = default;
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    Arena(Arena&& other) noexcept { swap(*this, other); }
+    Arena& operator=(Arena&& other) noexcept {
+        swap(*this, other);
+        return *this;
+    }
+
+    friend void swap(Arena& a, Arena& b) noexcept {
+        std::swap(a.blocks_, b.blocks_);
+        std::swap(a.cursor_, b.cursor_);
+        std::swap(a.remaining_, b.remaining_);
+        std::swap(a.bytes_reserved_, b.bytes_reserved_);
+    }
+
+    void* allocate(std::size_t size,
+                   std::size_t align = alignof(std::max_align_t)) {
+        auto padding = static_cast<std::size_t>(
+            -reinterpret_cast<std::uintptr_t>(cursor_) & (align - 1));
+        if (padding + size > remaining_) {
+            // big allocations get a block of their own, so the current
+            // block keeps serving the small ones
+            if (size > block_size / 4) return new_block(size);
+
+            cursor_ = new_block(block_size);
+            remaining_ = block_size;
+            padding = 0;
+        }
+
+        auto* result = cursor_ + padding;
+        cursor_ += padding + size;
+        remaining_ -= padding + size;
+        return result;
+    }
+
+    // Copies `bytes` into the arena and returns a view of the copy.
+    std::string_view copy(std::string_view bytes) {
+        if (bytes.empty()) return {};
+
+        auto* data = static_cast<char*>(allocate(bytes.size(), 1));
+        std::memcpy(data, bytes.data(), bytes.size());
+        return {data, bytes.size()};
+    }
+
+    void clear() { *this = Arena(); }
+
+    // total size of the blocks obtained from the heap
+    std::size_t bytes_reserved() const { return bytes_reserved_; }
+
+   private:
+    char* new_block(std::size_t size) {
+        blocks_.emplace_back(new char[size]);
+        bytes_reserved_ += size;
+        return blocks_.back().get();
+    }
+};
+}  // namespace hashfu
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string_view>
+#include <utility>
+
+namespace hashfu {
+
+/* KeyTraits for std::string_view keys whose hash can be evaluated at
+ * compile time (FNV-1a), as ConstexprHashMap needs. */
+struct StringViewTraits {
+    static constexpr unsigned hash(std::string_view val) {
+        std::uint32_t hash = 2166136261u;
+        for (char c : val) {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+    static constexpr bool equals(std::string_view a, std::string_view b) {
+        return a == b;
+    }
+};
+
+/* Fixed-capacity open addressing map that can be built entirely at compile
+ * time. Declared `static constexpr`, the probe table ends up in read-only
+ * data, so static lookup tables cost neither startup time nor heap.
+ * KeyTraits follows the usual contract, with hash() and equals() marked
+ * constexpr; K and V must be literal, default constructible types.
+ *
+ *   static constexpr auto keywords =
+ *       make_constexpr_hash_map<std::string_view, int, StringViewTraits>(
+ *           {{"if", 1}, {"else", 2}, {"while", 3}});
+ *   static_assert(*keywords.find("else") == 2);
+ *
+ * Capacity has to leave at least one slot empty so that unsuccessful
+ * lookups terminate. Running out of room fails compilation; filled at
+ * runtime, a full map refuses the insert instead.
+ */
+template <typename K, typename V, typename KeyTraits, std::size_t Capacity>
+class ConstexprHashMap {
+    static_assert(Capacity > 0, "ConstexprHashMap needs a slot to be empty");
+
+    struct Slot {
+        K key{};
+        V value{};
+        bool used{false};
+    };
+
+    Slot slots_[Capacity]{};
+    std::size_t size_{0};
+
+   public:
+    constexpr ConstexprHashMap() = default;
+    constexpr ConstexprHashMap(std::initializer_list<std::pair<K, V>> list) {
+        for (const auto& entry : list) {
+            [[maybe_unused]] bool inserted = insert(entry.first, entry.second);
+            assert(inserted);
+        }
+    }
+
+    [[nodiscard]] constexpr bool empty() const { return size_ == 0; }
+    constexpr std::size_t size() const { return size_; }
+    constexpr std::size_t capacity() const { return Capacity; }
+
+    constexpr const V* find(const K& key) const {
+        auto index = KeyTraits::hash(key) % Capacity;
+        for (;;) {
+            const auto& slot = slots_[index];
+            if (!slot.used) return nullptr;
+            if (KeyTraits::equals(slot.key, key)) return &slot.value;
+
+            // Linear probing
+            index = (index + 1) % Capacity;
+        }
+    }
+
+    constexpr bool contains(const K& key) const { return find(key) != nullptr; }
+
+    /* Later entries for an existing key replace its value, like insert()
+     * on HashMap does. Returns false, leaving the map as it was, if a new
+     * key doesn't fit. */
+    constexpr bool insert(const K& key, const V& value) {
+        auto index = KeyTraits::hash(key) % Capacity;
+        for (;;) {
+            auto& slot = slots_[index];
+            if (!slot.used) break;
+            if (KeyTraits::equals(slot.key, key)) {
+                slot.value = value;
+                return true;
+            }
+
+            // Linear probing
+            index = (index + 1) % Capacity;
+        }
+
+        if (size_ + 1 >= Capacity) {
+            capacity_exceeded();
+            return false;
+        }
+
+        slots_[index].key = key;
+        slots_[index].value = value;
+        slots_[index].used = true;
+        ++size_;
+        return true;
+    }
+
+   private:
+    // Not constexpr on purpose: reaching it during constant evaluation is
+    // what turns a full table into a compile error. At runtime it does
+    // nothing, and insert() reports the full map.
+    static void capacity_exceeded() {}
+};
+
+// Capacity used by make_constexpr_hash_map: a power of two, at least twice
+// the number of entries.
+constexpr std::size_t constexpr_hash_map_capacity(std::size_t entries) {
+    std::size_t capacity = 2;
+    while (capacity < entries * 2) capacity *= 2;
+    return capacity;
+}
+
+template <typename K, typename V, typename KeyTraits, std::size_t N>
+constexpr auto make_constexpr_hash_map(const std::pair<K, V> (&entries)[N]) {
+    ConstexprHashMap<K, V, KeyTraits, constexpr_hash_map_capacity(N)> map;
+    for (const auto& entry : entries) {
+        [[maybe_unused]] bool inserted = map.insert(entry.first, entry.second);
+        assert(inserted);
+    }
+    return map;
+}
+}  // namespace hashfu
@@ -0,0 +1,214 @@
+#pragma once
+
+/* Optional: needs C++20 coroutines, whereas the rest of hashfu is C++17.
+ *
+ * Every lookup runs as a small coroutine that issues a prefetch for the
+ * bucket it is about to look at and suspends. A scheduler keeps `width`
+ * such lookups in flight and resumes them round-robin, so while one lookup
+ * waits on memory the others make progress. Unlike find_batch(), which only
+ * prefetches the home bucket, a lookup that runs into a long probe
+ * sequence prefetches and suspends again every time it crosses into a new
+ * cache line, without holding back the rest of the batch.
+ */
+
+#if !defined(__cpp_impl_coroutine)
+#error "CoroLookup.h requires C++20 coroutines"
+#endif
+
+#include <algorithm>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <new>
+
+#include "HashTable.h"
+
+namespace hashfu {
+
+template <typename HashTableType>
+class CoroLookup {
+    using T = typename HashTableType::value_type;
+    using Bucket = typename HashTableType::Bucket;
+    using ConstIterator = typename HashTableType::ConstIterator;
+    using Traits = typename HashTableType::traits_type;
+
+    static constexpr std::uintptr_t cache_line_size = 64;
+
+    /* All frames of a probe coroutine have the same size, so finished ones
+     * are kept on a free list and reused instead of going back to the heap
+     * for every lookup. */
+    struct FramePool {
+        struct Node {
+            Node* next;
+        };
+        Node* head{nullptr};
+
+        ~FramePool() {
+            while (head) {
+                auto* next = head->next;
+                ::operator delete(head);
+                head = next;
+            }
+        }
+
+        static FramePool& instance() {
+            thread_local FramePool pool;
+            return pool;
+        }
+    };
+
+    struct Probe {
+        struct promise_type {
+            Probe get_return_object() {
+                return Probe{
+                    std::coroutine_handle<promise_type>::from_promise(*this)};
+            }
+            // run up to the first prefetch right away
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_always final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() { std::terminate(); }
+
+            static void* operator new(std::size_t size) {
+                auto& pool = FramePool::instance();
+                if (!pool.head) return ::operator new(size);
+
+                auto* frame = pool.head;
+                pool.head = frame->next;
+                return frame;
+            }
+            static void operator delete(void* frame) {
+                auto& pool = FramePool::instance();
+                auto* node = static_cast<typename FramePool::Node*>(frame);
+                node->next = pool.head;
+                pool.head = node;
+            }
+        };
+
+        std::coroutine_handle<promise_type> coroutine;
+    };
+
+    static std::uintptr_t cache_line_of(const Bucket* bucket) {
+        return reinterpret_cast<std::uintptr_t>(bucket) / cache_line_size;
+    }
+
+    static Probe probe(const HashTableType& table, const T& value,
+                       const Bucket*& result) {
+        auto index = table.hash_of(value) % table.capacity_;
+        const auto* bucket = &table.buckets_[index];
+
+        __builtin_prefetch(bucket);
+        co_await std::suspend_always{};
+
+        for (;;) {
+            if (bucket->used &&
+                Traits::equals(*bucket->slot(), value)) {
+                result = bucket;
+                co_return;
+            }
+            if (!bucket->used && !bucket->deleted) {
+                result = nullptr;
+                co_return;
+            }
+
+            // Linear probing
+            auto line = cache_line_of(bucket);
+            index = (index + 1) % table.capacity_;
+            bucket = &table.buckets_[index];
+
+            if (cache_line_of(bucket) != line) {
+                __builtin_prefetch(bucket);
+                co_await std::suspend_always{};
+            }
+        }
+    }
+
+    // Runs `n` probes, at most `width` at a time; results[i] is the bucket
+    // holding values[i] or nullptr.
+    static void run(const HashTableType& table, const T* values, std::size_t n,
+                    const Bucket** results, std::size_t width) {
+        if (table.empty()) {
+            for (std::size_t i = 0; i < n; ++i) results[i] = nullptr;
+            return;
+        }
+
+        constexpr std::size_t max_width = 64;
+        width = std::max<std::size_t>(1, std::min(width, max_width));
+
+        std::coroutine_handle<> in_flight[max_width];
+        std::size_t next = 0;
+        std::size_t active = 0;
+
+        for (std::size_t slot = 0; slot < width; ++slot) {
+            in_flight[slot] = nullptr;
+            if (next < n) {
+                in_flight[slot] =
+                    probe(table, values[next], results[next]).coroutine;
+                ++next;
+                ++active;
+            }
+        }
+
+        while (active) {
+            for (std::size_t slot = 0; slot < width; ++slot) {
+                auto& lookup = in_flight[slot];
+                if (!lookup) continue;
+
+                lookup.resume();
+                if (!lookup.done()) continue;
+
+                lookup.destroy();
+                lookup = nullptr;
+                --active;
+
+                if (next < n) {
+                    lookup =
+                        probe(table, values[next], results[next]).coroutine;
+                    ++next;
+                    ++active;
+                }
+            }
+        }
+    }
+
+    // Same as run(), but hands results to `sink(index, bucket)` in chunks
+    // so callers don't need a scratch array as big as the whole batch.
+    template <typename Sink>
+    static void run_chunked(const HashTableType& table, const T* values,
+                            std::size_t n, std::size_t width, Sink sink) {
+        constexpr std::size_t chunk_size = 256;
+        const Bucket* results[chunk_size];
+
+        for (std::size_t first = 0; first < n; first += chunk_size) {
+            auto count = std::min(chunk_size, n - first);
+            run(table, values + first, count, results, width);
+            for (std::size_t i = 0; i < count; ++i) {
+                sink(first + i, results[i]);
+            }
+        }
+    }
+
+   public:
+    static constexpr std::size_t default_width = 16;
+
+    // Interleaved lookups: out[i] receives the result for values[i].
+    static void find(const HashTableType& table, const T* values,
+                     std::size_t n, ConstIterator* out,
+                     std::size_t width = default_width) {
+        run_chunked(table, values, n, width,
+                    [&table, out](std::size_t i, const Bucket* bucket) {
+                        out[i] = table.iterator_for(bucket);
+                    });
+    }
+
+    static void contains(const HashTableType& table, const T* values,
+                         std::size_t n, bool* out,
+                         std::size_t width = default_width) {
+        run_chunked(table, values, n, width,
+                    [out](std::size_t i, const Bucket* bucket) {
+                        out[i] = bucket != nullptr;
+                    });
+    }
+};
+}  // namespace hashfu
@@ -0,0 +1,329 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <utility>
+
+#include "DisplacingTable.h"
+
+namespace hashfu {
+
+namespace detail {
+// bytes of a cuckoo bucket of `slots` entries of type T, before padding
+template <typename T>
+constexpr std::size_t cuckoo_bucket_bytes(std::size_t slots) {
+    auto header = (1 + slots + alignof(T) - 1) / alignof(T) * alignof(T);
+    return header + slots * sizeof(T);
+}
+
+// Most slots, from 2 to 8, that keep a bucket within one cache line, or 4
+// for entries too big for even 2.
+template <typename T>
+constexpr std::size_t cuckoo_default_slots() {
+    for (std::size_t slots = 8; slots >= 2; --slots) {
+        if (cuckoo_bucket_bytes<T>(slots) <= 64) return slots;
+    }
+    return 4;
+}
+
+template <typename T, std::size_t Slots>
+struct alignas(64) CuckooBucket {
+    // bit s is set while slot s holds an entry
+    std::uint8_t occupied;
+    // top byte of each entry's hash, which rules out most mismatches
+    // without calling equals()
+    std::uint8_t tags[Slots];
+    alignas(T) unsigned char storage[Slots][sizeof(T)];
+
+    bool used(std::size_t s) const { return (occupied >> s) & 1; }
+    T* slot(std::size_t s) { return reinterpret_cast<T*>(storage[s]); }
+    const T* slot(std::size_t s) const {
+        return reinterpret_cast<const T*>(storage[s]);
+    }
+};
+}  // namespace detail
+
+/* HashTable alternative that runs at up to 95% occupancy (see
+ * load_factor_percent), for when memory matters more than the last
+ * nanosecond of a lookup: HashTable keeps at least 40% of its buckets
+ * empty. Every entry lives in one of two buckets of Slots slots, picked
+ * by two hash functions derived from TraitsForT's, so a lookup reads two
+ * buckets and never probes further. An insert that finds both full moves
+ * entries to their other bucket along the shortest path a breadth-first
+ * search turns up, and grows the table only when there is none.
+ *
+ * Buckets start on a cache line, and the default Slots is as many as fit
+ * in one: 7 for 8-byte entries, 3 for 16-byte ones, 2 for up to 24 or so.
+ * A lookup then touches two cache lines. Bigger entries, or more slots
+ * than the default, take sizeof(Bucket) / 64 lines per bucket.
+ *
+ * The public API is HashTable's, without snapshots. Inserts may move
+ * entries, so they invalidate iterators and references. Entries that fit
+ * nowhere in a table less than half full, which takes many keys with the
+ * same hash, go to a small overflow list that lookups scan as well.
+ */
+template <typename T, typename TraitsForT = DefaultTraits<T>,
+          std::size_t Slots = detail::cuckoo_default_slots<T>()>
+class CuckooHashTable
+    : public detail::DisplacingTable<CuckooHashTable<T, TraitsForT, Slots>,
+                                     T, TraitsForT,
+                                     detail::CuckooBucket<T, Slots>> {
+    static_assert(Slots >= 1 && Slots <= 8, "a bucket has 1 to 8 slots");
+
+    using Bucket = detail::CuckooBucket<T, Slots>;
+    using Base =
+        detail::DisplacingTable<CuckooHashTable, T, TraitsForT, Bucket>;
+    friend Base;
+    static_assert(sizeof(Bucket) ==
+                      (detail::cuckoo_bucket_bytes<T>(Slots) + 63) / 64 * 64,
+                  "cuckoo_bucket_bytes() must match the bucket layout");
+
+    using Base::bucket_count_;
+    using Base::buckets_;
+
+   public:
+    using typename Base::size_type;
+    using typename Base::value_type;
+
+    static constexpr size_type slots_per_bucket = Slots;
+    // The table grows before more than this share of slots is in use.
+    // Fewer slots leave the moves on insert fewer ways out.
+    static constexpr size_t load_factor_percent =
+        Slots >= 4 ? 95 : Slots == 3 ? 90 : Slots == 2 ? 75 : 45;
+
+    CuckooHashTable() = default;
+    explicit CuckooHashTable(size_type capacity) { this->reserve(capacity); }
+
+    template <typename InputIt>
+    CuckooHashTable(InputIt first, InputIt last, size_type bucket_count = 4) {
+        this->reserve(bucket_count);
+
+        while (first != last) {
+            this->insert(*first);
+            ++first;
+        }
+    }
+
+    CuckooHashTable(std::initializer_list<value_type> list)
+        : CuckooHashTable(list.begin(), list.end(), list.size()) {}
+
+    ~CuckooHashTable() { this->destroy(); }
+
+    CuckooHashTable(const CuckooHashTable& other) : Base() {
+        this->reserve(other.size());
+
+        for (const auto& i : other) {
+            this->insert(i);
+        }
+    }
+    CuckooHashTable& operator=(const CuckooHashTable&) = default;
+    CuckooHashTable(CuckooHashTable&&) noexcept = default;
+    CuckooHashTable& operator=(CuckooHashTable&&) noexcept = default;
+
+    CuckooHashTable& operator=(std::initializer_list<value_type> list) {
+        CuckooHashTable temp(list);
+        this->swap(*this, temp);
+        return *this;
+    }
+
+    // Pulls both buckets of `hash` into cache ahead of a lookup.
+    void prefetch(unsigned hash) const {
+        if (!buckets_) return;
+        auto first = primary_bucket(hash);
+        __builtin_prefetch(&buckets_[first]);
+        __builtin_prefetch(&buckets_[alternate_bucket(first, hash)]);
+    }
+
+   private:
+    // a bucket count of 1 would give both buckets of a key the same index
+    static constexpr size_type min_buckets = 2;
+    // BFS limits: moves per insert, and buckets looked at
+    static constexpr size_type max_moves = 5;
+    static constexpr size_type max_search = 512;
+
+    // positions are bucket * Slots + slot
+    size_type table_end() const { return this->capacity(); }
+    T* slot_at(size_type position) {
+        return buckets_[position / Slots].slot(position % Slots);
+    }
+
+    size_type next_used_in_table(size_type from) const {
+        for (auto b = from / Slots; b < bucket_count_; ++b) {
+            unsigned occupied = buckets_[b].occupied;
+            if (b == from / Slots) occupied &= ~0u << (from % Slots);
+            if (occupied) {
+                return b * Slots +
+                       static_cast<size_type>(__builtin_ctz(occupied));
+            }
+        }
+        return table_end();
+    }
+
+    // The first bucket of a hash takes its low bits; the second is the
+    // first moved by a mix of all of them, and never the first itself.
+    size_type primary_bucket(unsigned hash) const {
+        return hash & (bucket_count_ - 1);
+    }
+    size_type alternate_bucket(size_type primary, unsigned hash) const {
+        auto mixed = static_cast<size_type>(
+            (std::uint64_t{hash} * 0x9e3779b97f4a7c15ull) >> 32);
+        return primary ^ ((mixed & (bucket_count_ - 1)) | 1);
+    }
+    static std::uint8_t tag_of(unsigned hash) {
+        return static_cast<std::uint8_t>(hash >> 24);
+    }
+
+    template <typename Pred>
+    size_type lookup_in_table(unsigned hash, Pred predicate) const {
+        auto tag = tag_of(hash);
+        auto first = primary_bucket(hash);
+        for (auto b : {first, alternate_bucket(first, hash)}) {
+            const auto& bucket = buckets_[b];
+            for (size_type s = 0; s < Slots; ++s) {
+                if (bucket.used(s) && bucket.tags[s] == tag &&
+                    predicate(*bucket.slot(s)))
+                    return b * Slots + s;
+            }
+        }
+        return table_end();
+    }
+
+    void remove_from_table(size_type position) {
+        auto& bucket = buckets_[position / Slots];
+        auto s = position % Slots;
+        assert(bucket.used(s));
+        bucket.slot(s)->~T();
+        bucket.occupied &= static_cast<std::uint8_t>(~(1u << s));
+    }
+
+    // index of a free slot of bucket `b`, or Slots if it is full
+    size_type free_slot(size_type b) const {
+        auto free = ~unsigned{buckets_[b].occupied} & ((1u << Slots) - 1);
+        return free ? static_cast<size_type>(__builtin_ctz(free)) : Slots;
+    }
+
+    /* Copies `value` into one of its buckets, first moving other entries
+     * to their other bucket if both are full. Returns false if no path of
+     * at most max_moves moves frees a slot. */
+    bool place(unsigned hash, const T& value) {
+        auto first = primary_bucket(hash);
+        auto second = alternate_bucket(first, hash);
+
+        size_type target = first;
+        if (free_slot(first) == Slots) {
+            target = second;
+            if (free_slot(second) == Slots && !make_room(first, second, target))
+                return false;
+        }
+
+        auto s = free_slot(target);
+        auto& bucket = buckets_[target];
+        new (bucket.slot(s)) T(value);
+        bucket.tags[s] = tag_of(hash);
+        bucket.occupied |= static_cast<std::uint8_t>(1u << s);
+        return true;
+    }
+
+    struct SearchNode {
+        size_type bucket;
+        // index of the node this one was reached from, or no_parent
+        size_type parent;
+        // slot of the parent's bucket whose entry would move here
+        size_type slot;
+        // moves it takes to bring an entry into this bucket
+        size_type depth;
+    };
+    static constexpr size_type no_parent = ~size_type{0};
+
+    /* Breadth-first search from buckets `first` and `second` for a bucket
+     * with a free slot, each step going from a bucket to the other bucket
+     * of one of its entries. The entries along the path found are moved
+     * one step each, starting at its far end, which frees a slot in
+     * whichever of the two buckets the path starts from: `freed`. */
+    bool make_room(size_type first, size_type second, size_type& freed) {
+        SearchNode nodes[max_search];
+        size_type count = 0;
+        nodes[count++] = {first, no_parent, 0, 0};
+        nodes[count++] = {second, no_parent, 0, 0};
+
+        for (size_type next = 0; next < count; ++next) {
+            auto node = nodes[next];
+            if (node.depth == max_moves) break;
+
+            for (size_type s = 0; s < Slots; ++s) {
+                auto hash = this->hash_of(*buckets_[node.bucket].slot(s));
+                auto home = primary_bucket(hash);
+                auto other = home == node.bucket
+                                 ? alternate_bucket(home, hash)
+                                 : home;
+                // the moves along a path must not run into each other
+                if (on_path(nodes, next, other)) continue;
+
+                if (free_slot(other) != Slots) {
+                    freed = move_along(nodes, next, s, other);
+                    return true;
+                }
+                if (count < max_search) {
+                    nodes[count++] = {other, next, s, node.depth + 1};
+                }
+            }
+        }
+        return false;
+    }
+
+    static bool on_path(const SearchNode* nodes, size_type index,
+                        size_type bucket) {
+        for (; index != no_parent; index = nodes[index].parent) {
+            if (nodes[index].bucket == bucket) return true;
+        }
+        return false;
+    }
+
+    // Moves slot `s` of node `index`'s bucket to `to`, then fills the hole
+    // from the parent and so on; returns the bucket left with a free slot.
+    size_type move_along(const SearchNode* nodes, size_type index,
+                         size_type s, size_type to) {
+        for (;;) {
+            auto from = nodes[index].bucket;
+            move_entry(from, s, to);
+            if (nodes[index].parent == no_parent) return from;
+
+            to = from;
+            s = nodes[index].slot;
+            index = nodes[index].parent;
+        }
+    }
+
+    void move_entry(size_type from, size_type s, size_type to) {
+        auto& source = buckets_[from];
+        auto& target = buckets_[to];
+        auto t = free_slot(to);
+        assert(t != Slots);
+
+        new (target.slot(t)) T(std::move(*source.slot(s)));
+        target.tags[t] = source.tags[s];
+        target.occupied |= static_cast<std::uint8_t>(1u << t);
+
+        source.slot(s)->~T();
+        source.occupied &= static_cast<std::uint8_t>(~(1u << s));
+    }
+
+    // Points an empty table at a fresh bucket array.
+    bool allocate(size_type bucket_count) {
+        assert(!buckets_ && bucket_count >= min_buckets);
+        buckets_ = Base::allocate_buckets(bucket_count);
+        if (!buckets_) return false;
+
+        for (size_type b = 0; b < bucket_count; ++b) buckets_[b].occupied = 0;
+        bucket_count_ = bucket_count;
+        return true;
+    }
+};
+
+/* CuckooHashTable with the default slot count, for HashMap's Table, which
+ * takes a template of the entry type and its traits only. */
+template <typename T, typename TraitsForT = DefaultTraits<T>>
+using CuckooTable = CuckooHashTable<T, TraitsForT>;
+}  // namespace hashfu
@@ -0,0 +1,656 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define HASHFU_X86_KERNELS 1
+#endif
+
+namespace hashfu {
+
+namespace detail {
+
+__extension__ using uint128 = unsigned __int128;
+
+// wyhash constants
+constexpr std::uint64_t secret[4] = {
+    0xa0761d6478bd642full, 0xe7037ed1a0b428dbull, 0x8ebc6af09c88c6e3ull,
+    0x589965cc75374cc3ull};
+
+// 64x64 -> 128 bit multiply, folded back to 64 bits
+inline std::uint64_t mum_fold(std::uint64_t a, std::uint64_t b) {
+    uint128 r = static_cast<uint128>(a) * b;
+    return static_cast<std::uint64_t>(r) ^ static_cast<std::uint64_t>(r >> 64);
+}
+
+// MurmurHash3's 64-bit finalizer: every input bit affects every output bit
+constexpr std::uint64_t fmix_m1 = 0xff51afd7ed558ccdull;
+constexpr std::uint64_t fmix_m2 = 0xc4ceb9fe1a85ec53ull;
+inline std::uint64_t fmix64(std::uint64_t x) {
+    x ^= x >> 33;
+    x *= fmix_m1;
+    x ^= x >> 33;
+    x *= fmix_m2;
+    x ^= x >> 33;
+    return x;
+}
+
+// Tables reduce hashes with a modulo, so keep entropy from both halves.
+inline unsigned fold(std::uint64_t x) {
+    return static_cast<unsigned>(x ^ (x >> 32));
+}
+
+inline std::uint64_t read64(const unsigned char* p) {
+    std::uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+inline std::uint64_t read32(const unsigned char* p) {
+    std::uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+// 1 to 3 bytes
+inline std::uint64_t read_small(const unsigned char* p, std::size_t len) {
+    return (std::uint64_t{p[0]} << 16) | (std::uint64_t{p[len >> 1]} << 8) |
+           p[len - 1];
+}
+
+// wyhash (final version 4) over `len` bytes
+inline std::uint64_t hash_bytes(const void* data, std::size_t len,
+                                std::uint64_t seed = 0) {
+    auto* p = static_cast<const unsigned char*>(data);
+    seed ^= mum_fold(seed ^ secret[0], secret[1]);
+
+    std::uint64_t a, b;
+    if (len <= 16) {
+        if (len >= 4) {
+            auto step = (len >> 3) << 2;
+            a = (read32(p) << 32) | read32(p + step);
+            b = (read32(p + len - 4) << 32) | read32(p + len - 4 - step);
+        } else if (len > 0) {
+            a = read_small(p, len);
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        auto i = len;
+        if (i > 48) {
+            auto see1 = seed, see2 = seed;
+            do {
+                seed = mum_fold(read64(p) ^ secret[1], read64(p + 8) ^ seed);
+                see1 = mum_fold(read64(p + 16) ^ secret[2],
+                                read64(p + 24) ^ see1);
+                see2 = mum_fold(read64(p + 32) ^ secret[3],
+                                read64(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = mum_fold(read64(p) ^ secret[1], read64(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+        a = read64(p + i - 16);
+        b = read64(p + i - 8);
+    }
+
+    uint128 r = static_cast<uint128>(a ^ secret[1]) * (b ^ seed);
+    a = static_cast<std::uint64_t>(r);
+    b = static_cast<std::uint64_t>(r >> 64);
+    return mum_fold(a ^ secret[0] ^ len, b ^ secret[1]);
+}
+
+// folds one more element hash into a running hash of a sequence
+inline std::uint64_t combine(std::uint64_t seed, unsigned hash) {
+    return fmix64(seed ^ (hash + 0x9e3779b97f4a7c15ull + (seed << 6) +
+                          (seed >> 2)));
+}
+
+/* fold(fmix64(x)) over arrays of 32- or 64-bit integers, several lanes at
+ * a time. Each kernel gives exactly the hashes the scalar code does. */
+template <typename I>
+void fmix64_batch_scalar(const I* in, std::size_t n, unsigned* out) {
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = fold(fmix64(static_cast<std::uint64_t>(in[i])));
+    }
+}
+
+#ifdef HASHFU_X86_KERNELS
+
+// AVX2 has no 64-bit multiply, so build the low half from 32-bit ones
+__attribute__((target("avx2"))) inline __m256i mullo64x4(__m256i a,
+                                                         __m256i b) {
+    auto cross = _mm256_add_epi64(
+        _mm256_mul_epu32(_mm256_srli_epi64(a, 32), b),
+        _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)));
+    return _mm256_add_epi64(_mm256_mul_epu32(a, b),
+                            _mm256_slli_epi64(cross, 32));
+}
+
+__attribute__((target("avx2"))) inline __m256i fmix64x4(__m256i x) {
+    x = _mm256_xor_si256(x, _mm256_srli_epi64(x, 33));
+    x = mullo64x4(x, _mm256_set1_epi64x(static_cast<long long>(fmix_m1)));
+    x = _mm256_xor_si256(x, _mm256_srli_epi64(x, 33));
+    x = mullo64x4(x, _mm256_set1_epi64x(static_cast<long long>(fmix_m2)));
+    return _mm256_xor_si256(x, _mm256_srli_epi64(x, 33));
+}
+
+template <typename I>
+__attribute__((target("avx2"))) void fmix64_batch_avx2(const I* in,
+                                                        std::size_t n,
+                                                        unsigned* out) {
+    // gathers the low 32 bits of each 64-bit lane into the bottom half
+    const auto low_halves = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i x;
+        if constexpr (sizeof(I) == 8) {
+            x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        } else {
+            auto narrow =
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            // widen the way static_cast<std::uint64_t> does
+            x = std::is_signed_v<I> ? _mm256_cvtepi32_epi64(narrow)
+                                    : _mm256_cvtepu32_epi64(narrow);
+        }
+        x = fmix64x4(x);
+        x = _mm256_xor_si256(x, _mm256_srli_epi64(x, 32));
+        x = _mm256_permutevar8x32_epi32(x, low_halves);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i),
+                         _mm256_castsi256_si128(x));
+    }
+    fmix64_batch_scalar(in + i, n - i, out + i);
+}
+
+// GCC 12 warns about the deliberately undefined registers inside its own
+// AVX-512 intrinsics
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+template <typename I>
+__attribute__((target("avx512f,avx512dq"))) void fmix64_batch_avx512(
+    const I* in, std::size_t n, unsigned* out) {
+    const auto m1 = _mm512_set1_epi64(static_cast<long long>(fmix_m1));
+    const auto m2 = _mm512_set1_epi64(static_cast<long long>(fmix_m2));
+
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512i x;
+        if constexpr (sizeof(I) == 8) {
+            x = _mm512_loadu_si512(in + i);
+        } else {
+            auto narrow =
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+            x = std::is_signed_v<I> ? _mm512_cvtepi32_epi64(narrow)
+                                    : _mm512_cvtepu32_epi64(narrow);
+        }
+        x = _mm512_xor_si512(x, _mm512_srli_epi64(x, 33));
+        x = _mm512_mullo_epi64(x, m1);
+        x = _mm512_xor_si512(x, _mm512_srli_epi64(x, 33));
+        x = _mm512_mullo_epi64(x, m2);
+        x = _mm512_xor_si512(x, _mm512_srli_epi64(x, 33));
+        x = _mm512_xor_si512(x, _mm512_srli_epi64(x, 32));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                            _mm512_cvtepi64_epi32(x));
+    }
+    fmix64_batch_scalar(in + i, n - i, out + i);
+}
+#pragma GCC diagnostic pop
+
+#endif  // HASHFU_X86_KERNELS
+
+// Runs the widest kernel this CPU supports, picked on first use.
+template <typename I>
+void fmix64_batch(const I* in, std::size_t n, unsigned* out) {
+    using Kernel = void (*)(const I*, std::size_t, unsigned*);
+    static const Kernel kernel = []() -> Kernel {
+#ifdef HASHFU_X86_KERNELS
+        if (__builtin_cpu_supports("avx512f") &&
+            __builtin_cpu_supports("avx512dq"))
+            return fmix64_batch_avx512<I>;
+        if (__builtin_cpu_supports("avx2")) return fmix64_batch_avx2<I>;
+#endif
+        return fmix64_batch_scalar<I>;
+    }();
+    kernel(in, n, out);
+}
+
+#ifdef HASHFU_X86_KERNELS
+
+/* Byte equality of two 32-byte objects: two SSE2 compares, which every
+ * x86-64 CPU has, or one AVX2 compare. */
+inline bool bytes_equal32_sse2(const unsigned char* x, const unsigned char* y) {
+    auto lo = _mm_cmpeq_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(x)),
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(y)));
+    auto hi = _mm_cmpeq_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(x + 16)),
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(y + 16)));
+    return _mm_movemask_epi8(_mm_and_si128(lo, hi)) == 0xffff;
+}
+
+__attribute__((target("avx2"))) inline bool bytes_equal32_avx2(
+    const unsigned char* x, const unsigned char* y) {
+    auto eq = _mm256_cmpeq_epi8(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x)),
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(y)));
+    return _mm256_movemask_epi8(eq) == -1;
+}
+
+using BytesEqualKernel = bool (*)(const unsigned char*, const unsigned char*);
+
+// The widest 32-byte compare this CPU supports, picked on first use.
+inline BytesEqualKernel bytes_equal32_kernel() {
+    static const BytesEqualKernel kernel =
+        __builtin_cpu_supports("avx2") ? bytes_equal32_avx2
+                                       : bytes_equal32_sse2;
+    return kernel;
+}
+
+#endif  // HASHFU_X86_KERNELS
+
+/* Byte equality of two N-byte objects. 16-byte keys such as UUIDs take a
+ * single SSE2 compare and 32-byte ones such as SHA-256 digests two, or one
+ * where the CPU has AVX2; other sizes go to memcmp, which the compiler
+ * inlines for small constant sizes anyway. */
+template <std::size_t N>
+inline bool bytes_equal(const void* a, const void* b) {
+#ifdef HASHFU_X86_KERNELS
+    auto* x = static_cast<const unsigned char*>(a);
+    auto* y = static_cast<const unsigned char*>(b);
+    if constexpr (N == 16) {
+        auto eq = _mm_cmpeq_epi8(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(x)),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(y)));
+        return _mm_movemask_epi8(eq) == 0xffff;
+    } else if constexpr (N == 32) {
+        return bytes_equal32_kernel()(x, y);
+    } else {
+        return std::memcmp(a, b, N) == 0;
+    }
+#else
+    return std::memcmp(a, b, N) == 0;
+#endif
+}
+
+/* Index of the first of the `count` N-byte keys stored back to back at
+ * `keys` whose bytes equal `key`'s, or `count` if there is none, for N a
+ * power of two up to 32. The kernels below all give the same answer: the
+ * scalar one compares a key at a time, the others as many keys as fit in
+ * one SSE2, AVX2 or AVX-512BW register. Keys left over go to the next
+ * narrower kernel, or with AVX-512 to one last masked compare. find_key()
+ * itself takes find_key_few() for short arrays, and otherwise the widest
+ * kernel the CPU has. */
+template <std::size_t N>
+std::size_t find_key_scalar(const unsigned char* keys, std::size_t count,
+                            const void* key) {
+    for (std::size_t i = 0; i < count; ++i) {
+        if (bytes_equal<N>(keys + i * N, key)) return i;
+    }
+    return count;
+}
+
+// find_key() for a handful of keys: a key at a time, like
+// find_key_scalar(), but with no early exit, so where the key turns up
+// costs no mispredicted branch. Below eight keys or so that beats any of
+// the vector kernels.
+template <std::size_t N>
+inline std::size_t find_key_few(const unsigned char* keys, std::size_t count,
+                                const void* key) {
+    // keys are unique, so at most one term of the OR is nonzero
+    std::size_t found = 0;
+    if constexpr (N <= 8) {
+        using Word = std::conditional_t<
+            N == 1, std::uint8_t,
+            std::conditional_t<N == 2, std::uint16_t,
+                               std::conditional_t<N == 4, std::uint32_t,
+                                                  std::uint64_t>>>;
+        Word wanted;
+        std::memcpy(&wanted, key, N);
+        for (std::size_t i = 0; i < count; ++i) {
+            Word word;
+            std::memcpy(&word, keys + i * N, N);
+            found |= word == wanted ? i + 1 : 0;
+        }
+    } else {
+        for (std::size_t i = 0; i < count; ++i) {
+            found |= bytes_equal<N>(keys + i * N, key) ? i + 1 : 0;
+        }
+    }
+    return found ? found - 1 : count;
+}
+
+#ifdef HASHFU_X86_KERNELS
+
+// The N <= 8 bytes of `key`, repeated across a 64-bit word.
+template <std::size_t N>
+inline std::uint64_t repeated_key(const void* key) {
+    std::uint64_t bits = 0;
+    std::memcpy(&bits, key, N);
+    for (std::size_t width = N; width < 8; width *= 2) {
+        bits |= bits << (8 * width);
+    }
+    return bits;
+}
+
+// From one bit per equal byte to one bit per equal N-byte key, at the
+// key's first byte.
+template <std::size_t N>
+constexpr std::uint64_t whole_keys(std::uint64_t eq) {
+    static_assert(N < 64);
+    for (std::size_t shift = 1; shift < N; shift *= 2) eq &= eq >> shift;
+    // bit 0 of every N-bit lane
+    constexpr auto starts = ~std::uint64_t{0} / ((std::uint64_t{1} << N) - 1);
+    return eq & starts;
+}
+
+template <std::size_t N>
+std::size_t find_key_sse2(const unsigned char* keys, std::size_t count,
+                          const void* key) {
+    static_assert(N <= 16);
+    constexpr std::size_t per_compare = 16 / N;
+    __m128i wanted;
+    if constexpr (N == 16) {
+        wanted = _mm_loadu_si128(static_cast<const __m128i*>(key));
+    } else {
+        wanted =
+            _mm_set1_epi64x(static_cast<long long>(repeated_key<N>(key)));
+    }
+
+    std::size_t i = 0;
+    for (; i + per_compare <= count; i += per_compare) {
+        auto eq = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i * N)),
+            wanted)));
+        if (auto hit = whole_keys<N>(eq)) {
+            return i + static_cast<std::size_t>(__builtin_ctzll(hit)) / N;
+        }
+    }
+    return i + find_key_scalar<N>(keys + i * N, count - i, key);
+}
+
+template <std::size_t N>
+__attribute__((target("avx2"))) std::size_t find_key_avx2(
+    const unsigned char* keys, std::size_t count, const void* key) {
+    static_assert(N <= 32);
+    constexpr std::size_t per_compare = 32 / N;
+    __m256i wanted;
+    if constexpr (N == 32) {
+        wanted = _mm256_loadu_si256(static_cast<const __m256i*>(key));
+    } else if constexpr (N == 16) {
+        wanted = _mm256_broadcastsi128_si256(
+            _mm_loadu_si128(static_cast<const __m128i*>(key)));
+    } else {
+        wanted =
+            _mm256_set1_epi64x(static_cast<long long>(repeated_key<N>(key)));
+    }
+
+    std::size_t i = 0;
+    for (; i + per_compare <= count; i += per_compare) {
+        auto eq = static_cast<std::uint32_t>(
+            _mm256_movemask_epi8(_mm256_cmpeq_epi8(
+                _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i*>(keys + i * N)),
+                wanted)));
+        if (auto hit = whole_keys<N>(eq)) {
+            return i + static_cast<std::size_t>(__builtin_ctzll(hit)) / N;
+        }
+    }
+    if constexpr (N <= 16) {
+        return i + find_key_sse2<N>(keys + i * N, count - i, key);
+    } else {
+        return i + find_key_scalar<N>(keys + i * N, count - i, key);
+    }
+}
+
+// GCC 12 warns about the deliberately undefined registers inside its own
+// AVX-512 intrinsics
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+template <std::size_t N>
+__attribute__((target("avx512f,avx512bw"))) std::size_t find_key_avx512(
+    const unsigned char* keys, std::size_t count, const void* key) {
+    static_assert(N <= 32);
+    constexpr std::size_t per_compare = 64 / N;
+    __m512i wanted;
+    if constexpr (N == 32) {
+        wanted = _mm512_broadcast_i64x4(
+            _mm256_loadu_si256(static_cast<const __m256i*>(key)));
+    } else if constexpr (N == 16) {
+        wanted = _mm512_broadcast_i32x4(
+            _mm_loadu_si128(static_cast<const __m128i*>(key)));
+    } else {
+        wanted =
+            _mm512_set1_epi64(static_cast<long long>(repeated_key<N>(key)));
+    }
+
+    for (std::size_t i = 0; i < count; i += per_compare) {
+        // the last compare loads only the keys left, so as not to read
+        // past them
+        auto left = count - i < per_compare ? (count - i) * N : 64;
+        auto loaded = left == 64 ? ~__mmask64{0}
+                                 : (__mmask64{1} << left) - 1;
+        auto eq = _mm512_mask_cmpeq_epi8_mask(
+            loaded, _mm512_maskz_loadu_epi8(loaded, keys + i * N), wanted);
+        if (auto hit = whole_keys<N>(eq)) {
+            return i + static_cast<std::size_t>(__builtin_ctzll(hit)) / N;
+        }
+    }
+    return count;
+}
+#pragma GCC diagnostic pop
+
+template <std::size_t N>
+using FindKeyKernel = std::size_t (*)(const unsigned char*, std::size_t,
+                                      const void*);
+
+// The widest find_key() kernel this CPU supports for N, picked on first
+// use.
+template <std::size_t N>
+FindKeyKernel<N> find_key_kernel() {
+    static const FindKeyKernel<N> kernel = []() -> FindKeyKernel<N> {
+        if (__builtin_cpu_supports("avx512f") &&
+            __builtin_cpu_supports("avx512bw"))
+            return find_key_avx512<N>;
+        if (__builtin_cpu_supports("avx2")) return find_key_avx2<N>;
+        if constexpr (N <= 16) return find_key_sse2<N>;
+        return find_key_scalar<N>;
+    }();
+    return kernel;
+}
+
+// The call through find_key_kernel(), kept out of line so that the guard
+// of its static doesn't stop find_key() from inlining.
+template <std::size_t N>
+__attribute__((noinline)) std::size_t find_key_wide(const unsigned char* keys,
+                                                    std::size_t count,
+                                                    const void* key) {
+    return find_key_kernel<N>()(keys, count, key);
+}
+
+#endif  // HASHFU_X86_KERNELS
+
+// Whether find_key() has vector kernels for N-byte keys.
+constexpr bool find_key_vectorized(std::size_t n) {
+    return n == 1 || n == 2 || n == 4 || n == 8 || n == 16 || n == 32;
+}
+
+template <std::size_t N>
+inline std::size_t find_key(const unsigned char* keys, std::size_t count,
+                            const void* key) {
+#ifdef HASHFU_X86_KERNELS
+    if constexpr (find_key_vectorized(N)) {
+        // 32-byte keys compare through a kernel of their own either way
+        if (N <= 16 && count < 8) return find_key_few<N>(keys, count, key);
+        return find_key_wide<N>(keys, count, key);
+    }
+#endif
+    return find_key_scalar<N>(keys, count, key);
+}
+
+// hash_batch() for the integer types the kernels above take
+template <typename T, typename = void>
+struct IntegerHashBatch {};
+
+template <typename T>
+struct IntegerHashBatch<
+    T, std::enable_if_t<std::is_integral_v<T> &&
+                        (sizeof(T) == 4 || sizeof(T) == 8)>> {
+    static void hash_batch(const T* values, std::size_t n, unsigned* out) {
+        fmix64_batch(values, n, out);
+    }
+};
+
+}  // namespace detail
+
+/* Ready-made traits for common key types, and the default traits of
+ * HashTable, HashMap and the other maps:
+ *
+ *   integers, enums, pointers   MurmurHash3 finalizer, so that sequential
+ *                               or strided keys still spread over buckets
+ *   floating point              the same over the bits, with -0.0 == 0.0
+ *   std::string, string_view    wyhash over the characters; lookups take
+ *                               any std::string_view. Seeded, so that
+ *                               each table hashes them differently
+ *   std::pair, std::tuple       element hashes combined in order
+ *   padding-free aggregates     wyhash over the object representation,
+ *                               e.g. struct Point { int x, y; } or
+ *                               std::array<std::uint8_t, 16>; compared
+ *                               bytewise, with SIMD for 16 and 32 bytes
+ *
+ * Other types need traits of their own. Every specialization has
+ *     static unsigned hash(const T&);
+ *     static bool equals(const T&, const T&);
+ * and the ones whose equals() compares exactly the object's bytes also
+ * declare bitwise_equals, which SmallHashMap uses to pick its vectorized
+ * scan.
+ * 32- and 64-bit integers also have
+ *     static void hash_batch(const T*, size_t n, unsigned* out);
+ * which hashes n keys with AVX2 or AVX-512 where the CPU has them; see
+ * HashTable::for_each_hashed(). Strings, which often come from outside,
+ * also have
+ *     static unsigned hash(const T&, std::uint64_t seed);
+ * which HashTable feeds a random per-table seed, so that colliding keys
+ * can't be worked out ahead of time; see HashTable::lookup_for_writing().
+ */
+template <typename T, typename = void>
+struct DefaultTraits;
+
+template <typename T>
+struct DefaultTraits<
+    T, std::enable_if_t<std::is_integral_v<T> || std::is_enum_v<T> ||
+                        std::is_pointer_v<T>>>
+    : detail::IntegerHashBatch<T> {
+    static constexpr bool bitwise_equals = std::is_integral_v<T>;
+
+    static unsigned hash(const T& value) {
+        std::uint64_t bits;
+        if constexpr (std::is_pointer_v<T>) {
+            bits = reinterpret_cast<std::uintptr_t>(value);
+        } else {
+            bits = static_cast<std::uint64_t>(value);
+        }
+        return detail::fold(detail::fmix64(bits));
+    }
+    static bool equals(const T& a, const T& b) { return a == b; }
+};
+
+template <typename T>
+struct DefaultTraits<T, std::enable_if_t<std::is_floating_point_v<T>>> {
+    static unsigned hash(const T& value) {
+        // -0.0 == 0.0, so they have to hash the same
+        if (value == 0) return detail::fold(detail::fmix64(0));
+        return detail::fold(detail::hash_bytes(&value, sizeof(T)));
+    }
+    static bool equals(const T& a, const T& b) { return a == b; }
+};
+
+template <>
+struct DefaultTraits<std::string_view> {
+    static unsigned hash(std::string_view value) {
+        return detail::fold(detail::hash_bytes(value.data(), value.size()));
+    }
+    static unsigned hash(std::string_view value, std::uint64_t seed) {
+        return detail::fold(
+            detail::hash_bytes(value.data(), value.size(), seed));
+    }
+    static bool equals(std::string_view a, std::string_view b) {
+        return a == b;
+    }
+};
+
+template <>
+struct DefaultTraits<std::string> : DefaultTraits<std::string_view> {};
+
+template <typename T>
+struct DefaultTraits<
+    T, std::enable_if_t<std::is_aggregate_v<T> && std::is_class_v<T> &&
+                        std::is_trivially_copyable_v<T> &&
+                        std::has_unique_object_representations_v<T>>> {
+    // no padding, so equal objects have equal bytes and vice versa
+    static constexpr bool bitwise_equals = true;
+
+    // sizeof(T) is a constant, so hash_bytes() inlines down to the few
+    // reads and multiplies that size needs
+    static unsigned hash(const T& value) {
+        return detail::fold(detail::hash_bytes(&value, sizeof(T)));
+    }
+    static bool equals(const T& a, const T& b) {
+        return detail::bytes_equal<sizeof(T)>(&a, &b);
+    }
+};
+
+template <typename A, typename B>
+struct DefaultTraits<std::pair<A, B>> {
+    static unsigned hash(const std::pair<A, B>& value) {
+        auto h = detail::combine(0, DefaultTraits<A>::hash(value.first));
+        return detail::fold(
+            detail::combine(h, DefaultTraits<B>::hash(value.second)));
+    }
+    static bool equals(const std::pair<A, B>& a, const std::pair<A, B>& b) {
+        return DefaultTraits<A>::equals(a.first, b.first) &&
+               DefaultTraits<B>::equals(a.second, b.second);
+    }
+};
+
+template <typename... Ts>
+struct DefaultTraits<std::tuple<Ts...>> {
+    static unsigned hash(const std::tuple<Ts...>& value) {
+        return hash_from(value, std::index_sequence_for<Ts...>());
+    }
+    static bool equals(const std::tuple<Ts...>& a,
+                       const std::tuple<Ts...>& b) {
+        return equals_from(a, b, std::index_sequence_for<Ts...>());
+    }
+
+   private:
+    template <std::size_t... I>
+    static unsigned hash_from(const std::tuple<Ts...>& value,
+                              std::index_sequence<I...>) {
+        std::uint64_t h = 0;
+        ((h = detail::combine(h, DefaultTraits<Ts>::hash(std::get<I>(value)))),
+         ...);
+        return detail::fold(h);
+    }
+    template <std::size_t... I>
+    static bool equals_from(const std::tuple<Ts...>& a,
+                            const std::tuple<Ts...>& b,
+                            std::index_sequence<I...>) {
+        return (DefaultTraits<Ts>::equals(std::get<I>(a), std::get<I>(b)) &&
+                ...);
+    }
+};
+}  // namespace hashfu
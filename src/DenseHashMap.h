@@ -0,0 +1,161 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "HashTable.h"
+
+namespace hashfu {
+
+/* HashMap variant that keeps its entries packed in a vector, in insertion
+ * order until something is removed, and probes a table of 32-bit indices
+ * into it. Iterating walks the vector without skipping empty buckets, and
+ * growing the table only moves the 8-byte slots.
+ *
+ * remove() fills the hole with the last entry, so it invalidates iterators
+ * and references to that entry; insert() may reallocate the vector and
+ * invalidate all of them.
+ *
+ * Seeded KeyTraits get a random seed per map, as in HashTable, but since
+ * the slots cache the hashes the map never reseeds.
+ */
+template <typename K, typename V, typename KeyTraits = DefaultTraits<K>>
+class DenseHashMap {
+   public:
+    struct Entry {
+        K key;
+        V value;
+    };
+
+   private:
+    struct Slot {
+        std::uint32_t index;
+        // cached so that rehashing never has to touch the entries
+        std::uint32_t hash;
+    };
+    struct SlotTraits {
+        static unsigned hash(const Slot& s) { return s.hash; }
+        // Inserts only happen after a lookup by key came up empty, so a new
+        // slot only has to be told apart from the ones already stored.
+        static bool equals(const Slot& a, const Slot& b) {
+            return a.index == b.index;
+        }
+    };
+    using HashTableType = HashTable<Slot, SlotTraits>;
+
+    // whether KeyTraits::hash takes the map's seed
+    static constexpr bool seeded = detail::has_seeded_hash_v<KeyTraits, K>;
+
+    std::vector<Entry> entries_;
+    HashTableType table_;
+    std::uint64_t seed_{seeded ? detail::new_table_seed() : 0};
+
+   public:
+    using Iterator = typename std::vector<Entry>::iterator;
+    using ConstIterator = typename std::vector<Entry>::const_iterator;
+
+    DenseHashMap() = default;
+
+    [[nodiscard]] bool empty() const { return entries_.empty(); }
+    size_t size() const { return entries_.size(); }
+    size_t capacity() const { return table_.capacity(); }
+    float load_factor() const { return table_.load_factor(); }
+
+    void clear() {
+        entries_.clear();
+        table_.clear();
+    }
+    void reserve(size_t count) {
+        entries_.reserve(count);
+        table_.reserve(count);
+    }
+
+    Iterator begin() noexcept { return entries_.begin(); }
+    Iterator end() noexcept { return entries_.end(); }
+    ConstIterator begin() const noexcept { return entries_.begin(); }
+    ConstIterator end() const noexcept { return entries_.end(); }
+    ConstIterator cbegin() const noexcept { return begin(); }
+    ConstIterator cend() const noexcept { return end(); }
+
+    // The entries in iteration order, contiguous.
+    Entry* data() noexcept { return entries_.data(); }
+    const Entry* data() const noexcept { return entries_.data(); }
+
+    Iterator find(const K& key) {
+        auto it = find_slot(key, hash_of(key));
+        return it != table_.end() ? begin() + it->index : end();
+    }
+    ConstIterator find(const K& key) const {
+        auto it = find_slot(key, hash_of(key));
+        return it != table_.end() ? begin() + it->index : end();
+    }
+
+    bool contains(const K& key) const { return find(key) != end(); }
+
+    HashTableResult insert(const K& key, const V& value) {
+        auto hash = hash_of(key);
+        auto it = find_slot(key, hash);
+        if (it != table_.end()) {
+            entries_[it->index].value = value;
+            return HashTableResult::ReplacedExistingEntry;
+        }
+
+        assert(entries_.size() < std::numeric_limits<std::uint32_t>::max());
+        auto index = static_cast<std::uint32_t>(entries_.size());
+        entries_.push_back({key, value});
+        return table_.insert_with_hash(hash, {index, hash});
+    }
+
+    bool remove(const K& key) {
+        auto it = find_slot(key, hash_of(key));
+        if (it == table_.end()) return false;
+
+        auto index = it->index;
+        table_.remove(it);
+
+        // move the last entry into the hole and repoint its slot
+        auto last = static_cast<std::uint32_t>(entries_.size() - 1);
+        if (index != last) {
+            auto moved = table_.find(
+                hash_of(entries_[last].key),
+                [last](const Slot& s) { return s.index == last; });
+            assert(moved != table_.end());
+            moved->index = index;
+            entries_[index] = std::move(entries_[last]);
+        }
+        entries_.pop_back();
+        return true;
+    }
+
+    V& operator[](const K& key) {
+        auto it = find(key);
+        if (it != end()) return it->value;
+
+        insert(key, V());
+        return entries_.back().value;
+    }
+
+   private:
+    unsigned hash_of(const K& key) const {
+        return detail::hash_with<KeyTraits>(key, seed_);
+    }
+
+    typename HashTableType::Iterator find_slot(const K& key, unsigned hash) {
+        return table_.find(hash, [&](const Slot& s) {
+            return s.hash == hash &&
+                   KeyTraits::equals(key, entries_[s.index].key);
+        });
+    }
+    typename HashTableType::ConstIterator find_slot(const K& key,
+                                                    unsigned hash) const {
+        return table_.find(hash, [&](const Slot& s) {
+            return s.hash == hash &&
+                   KeyTraits::equals(key, entries_[s.index].key);
+        });
+    }
+};
+}  // namespace hashfu
@@ -0,0 +1,407 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+#include "HashTable.h"
+
+namespace hashfu {
+namespace detail {
+
+/* What CuckooHashTable and HopscotchHashTable have in common: an array of
+ * buckets whose entries inserts move around to make room, an overflow
+ * list for the entries that fit nowhere, and a seed to start over with
+ * when that list fills up. This class has the public API and the insert
+ * loop; Derived says where entries go.
+ *
+ * An entry's position is its index among the Derived::table_end() places
+ * of the bucket array, then past those, its index in the overflow list.
+ * Derived provides, for Base to call:
+ *     slots_per_bucket, load_factor_percent, min_buckets
+ *     size_type table_end() const;
+ *     T* slot_at(size_type position);
+ *     // first used position in [from, table_end()), or table_end()
+ *     size_type next_used_in_table(size_type from) const;
+ *     // position of the entry matching `predicate`, or table_end()
+ *     size_type lookup_in_table(unsigned hash, Pred predicate) const;
+ *     // copies `value` in, or returns false if there is no room for it
+ *     bool place(unsigned hash, const T& value);
+ *     void remove_from_table(size_type position);
+ *     // points an empty table at bucket_count fresh buckets
+ *     bool allocate(size_type bucket_count);
+ *     void prefetch(unsigned hash) const;
+ * and destroy()s the entries in its destructor.
+ */
+template <typename Derived, typename T, typename TraitsForT, typename Bucket>
+class DisplacingTable {
+    // number of lookups kept in flight by the batch APIs
+    static constexpr std::size_t batch_size = 16;
+    // whether TraitsForT::hash takes the table's seed
+    static constexpr bool seeded = has_seeded_hash_v<TraitsForT, T>;
+
+    template <typename Table, typename U>
+    class IteratorBase {
+        friend DisplacingTable;
+
+        Table* table_{nullptr};
+        // see the positions above
+        std::size_t position_{0};
+
+        IteratorBase(Table* table, std::size_t position)
+            : table_(table), position_(position) {}
+
+       public:
+        IteratorBase() = default;
+
+        friend bool operator==(const IteratorBase& lhs,
+                               const IteratorBase& rhs) {
+            return lhs.position_ == rhs.position_;
+        }
+        friend bool operator!=(const IteratorBase& lhs,
+                               const IteratorBase& rhs) {
+            return lhs.position_ != rhs.position_;
+        }
+
+        U& operator*() { return *table_->entry_at(position_); }
+        U* operator->() { return table_->entry_at(position_); }
+
+        void operator++() { position_ = table_->next_used(position_ + 1); }
+    };
+
+   public:
+    using key_type = T;
+    using value_type = T;
+    using traits_type = TraitsForT;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+
+    DisplacingTable() = default;
+    DisplacingTable(const DisplacingTable&) = delete;
+    DisplacingTable& operator=(const DisplacingTable& other) {
+        if (this != &other) {
+            Derived temp(static_cast<const Derived&>(other));
+            swap(derived(), temp);
+        }
+        return *this;
+    }
+
+    DisplacingTable(DisplacingTable&& other) noexcept
+        : buckets_(other.buckets_),
+          bucket_count_(other.bucket_count_),
+          size_(other.size_),
+          overflow_(std::move(other.overflow_)),
+          seed_(other.seed_),
+          reseeded_at_(other.reseeded_at_) {
+        other.buckets_ = nullptr;
+        other.bucket_count_ = 0;
+        other.size_ = 0;
+    }
+    DisplacingTable& operator=(DisplacingTable&& other) noexcept {
+        swap(derived(), static_cast<Derived&>(other));
+        return *this;
+    }
+
+    void swap(Derived& a, Derived& b) noexcept {
+        std::swap(a.buckets_, b.buckets_);
+        std::swap(a.bucket_count_, b.bucket_count_);
+        std::swap(a.size_, b.size_);
+        std::swap(a.overflow_, b.overflow_);
+        std::swap(a.seed_, b.seed_);
+        std::swap(a.reseeded_at_, b.reseeded_at_);
+    }
+
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+    size_type size() const { return size_; }
+    // number of entries the buckets are sized for
+    size_type capacity() const {
+        return bucket_count_ * Derived::slots_per_bucket;
+    }
+    float load_factor() const {
+        return static_cast<float>(size_) / static_cast<float>(capacity());
+    }
+
+    using Iterator = IteratorBase<DisplacingTable, T>;
+    Iterator begin() noexcept { return Iterator(this, next_used(0)); }
+    Iterator end() noexcept { return Iterator(this, end_position()); }
+
+    using ConstIterator = IteratorBase<const DisplacingTable, const T>;
+    ConstIterator begin() const noexcept {
+        return ConstIterator(this, next_used(0));
+    }
+    ConstIterator cbegin() const noexcept { return begin(); }
+
+    ConstIterator end() const noexcept {
+        return ConstIterator(this, end_position());
+    }
+    ConstIterator cend() const noexcept { return end(); }
+
+    void clear() { derived() = Derived(); }
+
+    template <typename Pred>
+    Iterator find(unsigned hash, Pred predicate) {
+        return Iterator(this, lookup_with_hash(hash, predicate));
+    }
+    template <typename Pred>
+    ConstIterator find(unsigned hash, Pred predicate) const {
+        return ConstIterator(this, lookup_with_hash(hash, predicate));
+    }
+
+    Iterator find(const T& value) {
+        return find(hash_of(value), [&value](auto& entry) {
+            return TraitsForT::equals(entry, value);
+        });
+    }
+    ConstIterator find(const T& value) const {
+        return find(hash_of(value), [&value](auto& entry) {
+            return TraitsForT::equals(entry, value);
+        });
+    }
+
+    bool contains(const value_type& value) const {
+        return find(value) != end();
+    }
+
+    // Batched lookups: out[i] receives the result for values[i].
+    void find_batch(const T* values, size_type n, Iterator* out) {
+        for_each_hashed<TraitsForT>(values, n, [&](size_type i, unsigned hash) {
+            out[i] = find(hash, [&value = values[i]](auto& entry) {
+                return TraitsForT::equals(entry, value);
+            });
+        });
+    }
+    void find_batch(const T* values, size_type n, ConstIterator* out) const {
+        for_each_hashed<TraitsForT>(values, n, [&](size_type i, unsigned hash) {
+            out[i] = find(hash, [&value = values[i]](auto& entry) {
+                return TraitsForT::equals(entry, value);
+            });
+        });
+    }
+    void contains_batch(const T* values, size_type n, bool* out) const {
+        for_each_hashed<TraitsForT>(values, n, [&](size_type i, unsigned hash) {
+            out[i] = find(hash, [&value = values[i]](auto& entry) {
+                         return TraitsForT::equals(entry, value);
+                     }) != end();
+        });
+    }
+
+    // See HashTable::hash_of().
+    unsigned hash_of(const T& value) const {
+        return hash_with<TraitsForT>(value, seed_);
+    }
+    std::uint64_t seed() const { return seed_; }
+
+    // See HashTable::for_each_hashed().
+    template <typename KeyTraits, typename Key, typename Visitor>
+    void for_each_hashed(const Key* keys, size_type n, Visitor visit) const {
+        detail::for_each_hashed<KeyTraits, batch_size>(derived(), keys, n,
+                                                       visit);
+    }
+
+    HashTableResult insert(const value_type& value) {
+        return insert_with_hash(hash_of(value), value);
+    }
+    /* `hash` must be hash_of(value). Returns TableFull if the table needed
+     * to grow and there was not enough memory. */
+    HashTableResult insert_with_hash(unsigned hash, const value_type& value) {
+        assert(hash == hash_of(value));
+        auto found = lookup_with_hash(hash, [&value](auto& entry) {
+            return TraitsForT::equals(entry, value);
+        });
+        if (found != end_position()) {
+            *entry_at(found) = value;
+            return HashTableResult::ReplacedExistingEntry;
+        }
+
+        if ((used_in_table() + 1) * 100 >
+                capacity() * Derived::load_factor_percent &&
+            !rehash(std::max(Derived::min_buckets, bucket_count_ * 2))) {
+            return HashTableResult::TableFull;
+        }
+
+        while (!derived().place(hash, value)) {
+            // Moving entries could not make room. With the table mostly
+            // full that is expected and growing fixes it; otherwise too
+            // many keys hash alike, which a new seed breaks up.
+            if (used_in_table() * 2 >= capacity()) {
+                if (!rehash(bucket_count_ * 2))
+                    return HashTableResult::TableFull;
+            } else if (seeded && reseeded_at_ != bucket_count_ &&
+                       overflow_.size() >= max_overflow) {
+                if (!reseed()) return HashTableResult::TableFull;
+                hash = hash_of(value);
+            } else {
+                overflow_.push_back(value);
+                break;
+            }
+        }
+
+        ++size_;
+        return HashTableResult::InsertedNewEntry;
+    }
+
+    // See HashTable::insert_batch().
+    void insert_batch(const T* values, size_type n, HashTableResult* results) {
+        reserve(size_ + n);
+        for_each_hashed<TraitsForT>(values, n, [&](size_type i, unsigned hash) {
+            results[i] = insert_with_hash(hash, values[i]);
+        });
+    }
+
+    // Grows the table so that `count` entries fit without another rehash.
+    void reserve(size_type count) {
+        if (count * 100 <= capacity() * Derived::load_factor_percent) return;
+
+        auto needed = count * 100 / Derived::load_factor_percent + 1;
+        auto buckets = Derived::min_buckets;
+        while (buckets * Derived::slots_per_bucket < needed) buckets *= 2;
+        rehash(buckets);
+    }
+
+    void remove(Iterator iter) {
+        auto position = iter.position_;
+        assert(position < end_position());
+        if (position >= table_end()) {
+            // the last overflow entry takes the removed one's place
+            auto& entry = overflow_[position - table_end()];
+            if (&entry != &overflow_.back()) {
+                entry = std::move(overflow_.back());
+            }
+            overflow_.pop_back();
+        } else {
+            derived().remove_from_table(position);
+        }
+        --size_;
+    }
+    bool remove(const T& value) {
+        auto it = find(value);
+        if (it != end()) {
+            remove(it);
+            return true;
+        }
+
+        return false;
+    }
+
+   protected:
+    Bucket* buckets_{nullptr};
+    // a power of two: buckets are picked by the hash's low bits
+    size_type bucket_count_{0};
+    size_type size_{0};
+    std::vector<T> overflow_;
+    // passed to seeded traits; see reseed()
+    std::uint64_t seed_{seeded ? new_table_seed() : 0};
+    // bucket count the table last reseeded at; it reseeds once per size
+    size_type reseeded_at_{0};
+
+    ~DisplacingTable() = default;
+
+    // Gets room for `count` buckets that start on a cache line.
+    static Bucket* allocate_buckets(size_type count) {
+        constexpr size_type alignment =
+            std::max<size_type>(64, alignof(Bucket));
+        auto bytes =
+            (sizeof(Bucket) * count + alignment - 1) / alignment * alignment;
+        return static_cast<Bucket*>(std::aligned_alloc(alignment, bytes));
+    }
+
+    // Destroys the entries and frees the buckets, for ~Derived().
+    void destroy() {
+        if (!buckets_) return;
+
+        for (auto p = next_used(0); p < table_end(); p = next_used(p + 1)) {
+            derived().slot_at(p)->~T();
+        }
+        std::free(buckets_);
+        buckets_ = nullptr;
+    }
+
+   private:
+    // seeded tables reseed rather than let the overflow list grow past this
+    static constexpr size_type max_overflow = 8;
+
+    Derived& derived() { return static_cast<Derived&>(*this); }
+    const Derived& derived() const {
+        return static_cast<const Derived&>(*this);
+    }
+
+    size_type table_end() const { return buckets_ ? derived().table_end() : 0; }
+    size_type end_position() const { return table_end() + overflow_.size(); }
+    size_type used_in_table() const { return size_ - overflow_.size(); }
+
+    T* entry_at(size_type position) {
+        if (position >= table_end()) return &overflow_[position - table_end()];
+        return derived().slot_at(position);
+    }
+    const T* entry_at(size_type position) const {
+        return const_cast<DisplacingTable*>(this)->entry_at(position);
+    }
+
+    // first used position at or after `from`, or end_position()
+    size_type next_used(size_type from) const {
+        if (from < table_end()) return derived().next_used_in_table(from);
+        return from;
+    }
+
+    template <typename Pred>
+    size_type lookup_with_hash(unsigned hash, Pred predicate) const {
+        if (empty()) return end_position();
+
+        auto found = derived().lookup_in_table(hash, predicate);
+        if (found != table_end()) return found;
+        for (size_type i = 0; i < overflow_.size(); ++i) {
+            if (predicate(overflow_[i])) return table_end() + i;
+        }
+        return end_position();
+    }
+
+    /* Moves every entry into a table of at least `bucket_count` buckets,
+     * hashed with `seed`, doubling it as long as the entries don't all fit.
+     * Returns false, leaving the table as it was, if out of memory. */
+    bool rehash(size_type bucket_count) { return rehash(bucket_count, seed_); }
+    bool rehash(size_type bucket_count, std::uint64_t seed) {
+        for (;; bucket_count *= 2) {
+            Derived grown;
+            grown.seed_ = seed;
+            grown.reseeded_at_ = reseeded_at_;
+            if (!grown.allocate(bucket_count)) return false;
+
+            bool fits = true;
+            for (const auto& value : *this) {
+                if (!grown.place(grown.hash_of(value), value)) {
+                    // as in insert_with_hash(): only a crowded table grows
+                    if (grown.used_in_table() * 2 >= grown.capacity()) {
+                        fits = false;
+                        break;
+                    }
+                    grown.overflow_.push_back(value);
+                }
+                ++grown.size_;
+            }
+
+            if (fits) {
+                swap(derived(), grown);
+                return true;
+            }
+        }
+    }
+
+    /* Moves every entry to where a new seed puts it. Keys that hash alike
+     * under any seed would have every insert reseed, so it happens once
+     * per table size and after that they go to the overflow list.
+     * Returns false, leaving the table as it was, if out of memory. */
+    bool reseed() {
+        if (!rehash(bucket_count_, new_table_seed())) return false;
+        reseeded_at_ = bucket_count_;
+        return true;
+    }
+};
+
+}  // namespace detail
+}  // namespace hashfu
@@ -0,0 +1,360 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "HashMap.h"
+
+namespace hashfu {
+
+/* How keys and values are laid out in the blob section of a frozen image.
+ * bytes() gives the bytes to store, view() turns stored bytes back into
+ * something usable without copying them out of the image, and
+ * materialize() builds a full object from a view when one is needed.
+ * Codecs whose view() reads a fixed number of bytes whatever the stored
+ * size declare it as fixed_size, so that attach() can check for it. */
+template <typename T, typename = void>
+struct FrozenCodec;
+
+template <typename T>
+struct FrozenCodec<T, std::enable_if_t<std::is_trivially_copyable_v<T>>> {
+    using view_type = T;
+    static constexpr std::size_t fixed_size = sizeof(T);
+
+    static std::string_view bytes(const T& value) {
+        return {reinterpret_cast<const char*>(&value), sizeof(T)};
+    }
+    static view_type view(const char* data, std::size_t) {
+        T value;
+        std::memcpy(&value, data, sizeof(T));
+        return value;
+    }
+    static T materialize(view_type value) { return value; }
+};
+
+template <>
+struct FrozenCodec<std::string> {
+    using view_type = std::string_view;
+
+    static std::string_view bytes(const std::string& value) { return value; }
+    static view_type view(const char* data, std::size_t size) {
+        return {data, size};
+    }
+    static std::string materialize(view_type value) {
+        return std::string(value);
+    }
+};
+
+/* Read-only open addressing map queried in place from a file image, which
+ * is typically mmap()ed so that every process on the host shares the same
+ * page cache copy of it.
+ *
+ * Image layout, in native byte order:
+ *   Header
+ *   Slot[capacity]     linear probing on hash % capacity, like HashTable
+ *   blob               key and value bytes, referenced by offset
+ *
+ * Lookups compare the stored 32-bit hash first and then the key. If
+ * KeyTraits has an equals(const K&, view_type) overload it is used
+ * directly on the image, otherwise the stored key is materialized first,
+ * e.g. into a std::string for string keys.
+ */
+template <typename K, typename V, typename KeyTraits = DefaultTraits<K>>
+class FrozenHashMap {
+    using KeyCodec = FrozenCodec<K>;
+    using ValueCodec = FrozenCodec<V>;
+
+    static constexpr std::size_t load_factor_percent = 60;
+    static constexpr std::uint32_t current_version = 1;
+    static constexpr char expected_magic[8] = {'h', 'a', 's', 'h',
+                                               'f', 'u', 'f', '\0'};
+
+    struct Header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t slot_size;
+        std::uint64_t capacity;
+        std::uint64_t size;
+        std::uint64_t blob_size;
+    };
+    struct Slot {
+        std::uint64_t key_offset;
+        std::uint64_t value_offset;
+        std::uint32_t key_size;
+        std::uint32_t value_size;
+        std::uint32_t hash;
+        std::uint32_t used;
+    };
+
+    // Codec::fixed_size if the codec has one, else 0
+    template <typename Codec, typename = void>
+    struct fixed_size : std::integral_constant<std::size_t, 0> {};
+    template <typename Codec>
+    struct fixed_size<Codec, std::void_t<decltype(Codec::fixed_size)>>
+        : std::integral_constant<std::size_t, Codec::fixed_size> {};
+
+    template <typename View, typename = void>
+    struct equals_view : std::false_type {};
+    template <typename View>
+    struct equals_view<View, std::void_t<decltype(KeyTraits::equals(
+                                 std::declval<const K&>(),
+                                 std::declval<View>()))>> : std::true_type {};
+
+   public:
+    using key_view = typename KeyCodec::view_type;
+    using value_view = typename ValueCodec::view_type;
+
+   private:
+    const Header* header_{nullptr};
+    const Slot* slots_{nullptr};
+    const char* blob_{nullptr};
+    // set if the image was mapped by open() and has to be unmapped
+    void* mapping_{nullptr};
+    std::size_t mapping_size_{0};
+
+   public:
+    FrozenHashMap() = default;
+    ~FrozenHashMap() { close(); }
+
+    FrozenHashMap(const FrozenHashMap&) = delete;
+    FrozenHashMap& operator=(const FrozenHashMap&) = delete;
+
+    FrozenHashMap(FrozenHashMap&& other) noexcept { swap(*this, other); }
+    FrozenHashMap& operator=(FrozenHashMap&& other) noexcept {
+        swap(*this, other);
+        return *this;
+    }
+
+    friend void swap(FrozenHashMap& a, FrozenHashMap& b) noexcept {
+        std::swap(a.header_, b.header_);
+        std::swap(a.slots_, b.slots_);
+        std::swap(a.blob_, b.blob_);
+        std::swap(a.mapping_, b.mapping_);
+        std::swap(a.mapping_size_, b.mapping_size_);
+    }
+
+    // Writes the frozen image of `map`. Returns false if the stream failed.
+    static bool build(const HashMap<K, V, KeyTraits>& map, std::ostream& os) {
+        Header header{};
+        std::memcpy(header.magic, expected_magic, sizeof(expected_magic));
+        header.version = current_version;
+        header.slot_size = sizeof(Slot);
+        header.capacity = std::max<std::size_t>(
+            4, map.size() * 100 / load_factor_percent + 1);
+        header.size = map.size();
+
+        std::vector<Slot> slots(header.capacity);
+        std::string blob;
+
+        // keeps every object in the blob 8-byte aligned
+        auto append = [&blob](std::string_view bytes) {
+            auto offset = blob.size();
+            blob.append(bytes);
+            blob.resize((blob.size() + 7) & ~std::size_t{7});
+            return offset;
+        };
+
+        for (const auto& entry : map) {
+            auto hash = KeyTraits::hash(entry.key);
+            auto index = hash % header.capacity;
+            while (slots[index].used) {
+                // Linear probing
+                index = (index + 1) % header.capacity;
+            }
+
+            auto key = KeyCodec::bytes(entry.key);
+            auto value = ValueCodec::bytes(entry.value);
+
+            auto& slot = slots[index];
+            slot.key_offset = append(key);
+            slot.key_size = static_cast<std::uint32_t>(key.size());
+            slot.value_offset = append(value);
+            slot.value_size = static_cast<std::uint32_t>(value.size());
+            slot.hash = hash;
+            slot.used = 1;
+        }
+
+        header.blob_size = blob.size();
+
+        os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        os.write(reinterpret_cast<const char*>(slots.data()),
+                 static_cast<std::streamsize>(sizeof(Slot) * slots.size()));
+        os.write(blob.data(), static_cast<std::streamsize>(blob.size()));
+        return bool(os);
+    }
+    static bool build(const HashMap<K, V, KeyTraits>& map, const char* path) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        return file && build(map, file) && file.flush();
+    }
+
+    /* Maps the image at `path` read-only. Returns false if it can't be
+     * mapped or isn't a valid image for this map type. */
+    bool open(const char* path) {
+        close();
+
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) return false;
+
+        struct stat st;
+        void* mapping = MAP_FAILED;
+        if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+            mapping = ::mmap(nullptr, static_cast<std::size_t>(st.st_size),
+                             PROT_READ, MAP_SHARED, fd, 0);
+        }
+        ::close(fd);
+
+        if (mapping == MAP_FAILED) return false;
+
+        auto size = static_cast<std::size_t>(st.st_size);
+        if (!attach(mapping, size)) {
+            ::munmap(mapping, size);
+            return false;
+        }
+
+        mapping_ = mapping;
+        mapping_size_ = size;
+        return true;
+    }
+
+    /* Queries an image that is already in memory, which has to be 8-byte
+     * aligned and outlive the map. Images are untrusted input: every slot
+     * is checked once here, so that a corrupt one is rejected instead of
+     * making find() read outside the image or probe forever. */
+    bool attach(const void* data, std::size_t size) {
+        close();
+
+        if (reinterpret_cast<std::uintptr_t>(data) % alignof(Slot) != 0 ||
+            size < sizeof(Header)) {
+            return false;
+        }
+
+        const auto* header = static_cast<const Header*>(data);
+        if (std::memcmp(header->magic, expected_magic,
+                        sizeof(expected_magic)) != 0 ||
+            header->version != current_version ||
+            header->slot_size != sizeof(Slot) || header->capacity == 0 ||
+            (size - sizeof(Header)) / sizeof(Slot) < header->capacity ||
+            size - sizeof(Header) - header->capacity * sizeof(Slot) <
+                header->blob_size) {
+            return false;
+        }
+
+        header_ = header;
+        slots_ = reinterpret_cast<const Slot*>(header + 1);
+        blob_ = reinterpret_cast<const char*>(slots_ + header->capacity);
+
+        if (!slots_valid() || !hashes_match()) {
+            close();
+            return false;
+        }
+
+        return true;
+    }
+
+    void close() {
+        if (mapping_) ::munmap(mapping_, mapping_size_);
+        header_ = nullptr;
+        slots_ = nullptr;
+        blob_ = nullptr;
+        mapping_ = nullptr;
+        mapping_size_ = 0;
+    }
+
+    [[nodiscard]] bool empty() const { return size() == 0; }
+    std::size_t size() const { return header_ ? header_->size : 0; }
+    std::size_t capacity() const { return header_ ? header_->capacity : 0; }
+
+    std::optional<value_view> find(const K& key) const {
+        if (empty()) return std::nullopt;
+
+        auto hash = KeyTraits::hash(key);
+        auto index = hash % header_->capacity;
+        for (;;) {
+            const auto& slot = slots_[index];
+            if (!slot.used) return std::nullopt;
+
+            if (slot.hash == hash && key_equals(key, slot)) {
+                return ValueCodec::view(blob_ + slot.value_offset,
+                                        slot.value_size);
+            }
+
+            // Linear probing
+            index = (index + 1) % header_->capacity;
+        }
+    }
+
+    bool contains(const K& key) const { return find(key).has_value(); }
+
+   private:
+    bool key_equals(const K& key, const Slot& slot) const {
+        auto stored = KeyCodec::view(blob_ + slot.key_offset, slot.key_size);
+        if constexpr (equals_view<key_view>::value) {
+            return KeyTraits::equals(key, stored);
+        } else {
+            return KeyTraits::equals(key, KeyCodec::materialize(stored));
+        }
+    }
+
+    /* Whether every used slot's key and value lie within the blob, and
+     * the image holds as many entries as it claims with at least one slot
+     * left empty to end probes. */
+    bool slots_valid() const {
+        std::uint64_t used = 0;
+        for (std::size_t i = 0; i < header_->capacity; ++i) {
+            const auto& slot = slots_[i];
+            if (!slot.used) continue;
+
+            if (!in_blob<KeyCodec>(slot.key_offset, slot.key_size) ||
+                !in_blob<ValueCodec>(slot.value_offset, slot.value_size)) {
+                return false;
+            }
+            ++used;
+        }
+
+        return used == header_->size && used < header_->capacity;
+    }
+
+    template <typename Codec>
+    bool in_blob(std::uint64_t offset, std::uint32_t size) const {
+        constexpr auto fixed = fixed_size<Codec>::value;
+        if (fixed && size != fixed) return false;
+
+        return offset <= header_->blob_size &&
+               size <= header_->blob_size - offset;
+    }
+
+    /* Rehashes a sample of the stored keys, so that an image built with a
+     * different hash function is rejected instead of silently missing. */
+    bool hashes_match() const {
+        constexpr std::size_t sample_size = 16;
+
+        std::size_t checked = 0;
+        for (std::size_t i = 0;
+             i < header_->capacity && checked < sample_size; ++i) {
+            const auto& slot = slots_[i];
+            if (!slot.used) continue;
+
+            auto key = KeyCodec::materialize(
+                KeyCodec::view(blob_ + slot.key_offset, slot.key_size));
+            if (KeyTraits::hash(key) != slot.hash) return false;
+            ++checked;
+        }
+
+        return true;
+    }
+};
+}  // namespace hashfu
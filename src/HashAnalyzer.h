@@ -0,0 +1,311 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "HashTable.h"
+
+namespace hashfu {
+
+/* Measures how well a traits type's hash suits HashTable's linear probing
+ * on a sample of keys, before slow lookups show it in production. The
+ * sample should hold distinct keys that look like the real ones: a good
+ * hash on random integers says little about sequential ids.
+ *
+ *   auto report = analyze_hash<MyTraits>(keys);
+ *   report.print(std::cout);
+ *
+ * Keys are placed the way HashTable places them, at its maximum load
+ * factor. See tools/hash_analyzer.cpp for a command line front end.
+ */
+struct HashReport {
+    std::size_t keys = 0;
+    std::size_t buckets = 0;
+
+    // distinct keys sharing all 32 hash bits, and what chance alone gives
+    std::size_t hash_collisions = 0;
+    double expected_hash_collisions = 0;
+
+    /* Pearson's chi-square of the keys per bucket against a uniform
+     * spread, standardized: roughly normal for a good hash, so values
+     * much past 3 mean some buckets get far more than their share. */
+    double chi_square = 0;
+    double chi_square_z = 0;
+
+    // mean buckets probed by a lookup that finds its key, and by one
+    // that doesn't, against what a uniformly random hash would need
+    double probe_hit = 0;
+    double expected_probe_hit = 0;
+    double probe_miss = 0;
+    double expected_probe_miss = 0;
+
+    // runs of consecutive used buckets, which every probe has to cross
+    std::size_t longest_run = 0;
+    double mean_run = 0;
+    double expected_mean_run = 0;
+
+    /* Flipping one input bit should flip each output bit half the time.
+     * avalanche_mean is the mean share of output bits flipped, ideally
+     * 0.5; avalanche_worst_bias is the largest |P(flip) - 0.5| over all
+     * (input bit, output bit) pairs, ideally close to 0. Only measured for
+     * strings and keys whose bytes are their value. */
+    bool avalanche_tested = false;
+    double avalanche_mean = 0;
+    double avalanche_worst_bias = 0;
+
+    // thresholds generous enough that good hashes pass on small samples
+    bool collisions_ok() const {
+        return static_cast<double>(hash_collisions) <
+               4 * expected_hash_collisions + 8;
+    }
+    bool distribution_ok() const { return chi_square_z < 6; }
+    bool probing_ok() const {
+        return probe_miss < 2 * expected_probe_miss + 1;
+    }
+    bool avalanche_ok() const {
+        return !avalanche_tested ||
+               (std::fabs(avalanche_mean - 0.5) < 0.05 &&
+                avalanche_worst_bias < 0.25);
+    }
+    bool ok() const {
+        return collisions_ok() && distribution_ok() && probing_ok() &&
+               avalanche_ok();
+    }
+
+    void print(std::ostream& os) const {
+        auto verdict = [](bool good) { return good ? "ok" : "BAD"; };
+        os << "keys                 " << keys << " in " << buckets
+           << " buckets\n";
+        os << "32-bit collisions    " << hash_collisions << " (expected "
+           << expected_hash_collisions << ")  " << verdict(collisions_ok())
+           << "\n";
+        os << "chi-square           " << chi_square
+           << ", z = " << chi_square_z << "  " << verdict(distribution_ok())
+           << "\n";
+        os << "probes, hit          " << probe_hit << " (expected "
+           << expected_probe_hit << ")\n";
+        os << "probes, miss         " << probe_miss << " (expected "
+           << expected_probe_miss << ")  " << verdict(probing_ok())
+           << "\n";
+        os << "runs                 mean " << mean_run << " (expected "
+           << expected_mean_run << "), longest " << longest_run << "\n";
+        if (avalanche_tested) {
+            os << "avalanche            mean " << avalanche_mean
+               << ", worst bias " << avalanche_worst_bias << "  "
+               << verdict(avalanche_ok()) << "\n";
+        } else {
+            os << "avalanche            not measured for this key type\n";
+        }
+    }
+};
+
+namespace detail {
+
+// Hands out copies of a key with one input bit flipped, for the avalanche
+// test. Only keys whose bits all matter can be mutated this way.
+template <typename K, typename = void>
+struct BitFlipper {
+    static constexpr bool supported = false;
+};
+
+template <typename K>
+struct BitFlipper<K, std::enable_if_t<std::is_trivially_copyable_v<K> &&
+                                      std::has_unique_object_representations_v<
+                                          K>>> {
+    static constexpr bool supported = true;
+
+    static std::size_t bits(const K&) { return sizeof(K) * 8; }
+    template <typename Fn>
+    static void with_flipped(const K& key, std::size_t bit, Fn fn) {
+        unsigned char bytes[sizeof(K)];
+        std::memcpy(bytes, &key, sizeof(K));
+        bytes[bit / 8] ^= static_cast<unsigned char>(1u << (bit % 8));
+
+        K flipped;
+        std::memcpy(&flipped, bytes, sizeof(K));
+        fn(static_cast<const K&>(flipped));
+    }
+};
+
+template <typename K>
+struct BitFlipper<K, std::enable_if_t<std::is_same_v<K, std::string> ||
+                                      std::is_same_v<K, std::string_view>>> {
+    static constexpr bool supported = true;
+
+    static std::size_t bits(const K& key) { return key.size() * 8; }
+    template <typename Fn>
+    static void with_flipped(const K& key, std::size_t bit, Fn fn) {
+        std::string flipped(key);
+        flipped[bit / 8] =
+            static_cast<char>(flipped[bit / 8] ^ (1 << (bit % 8)));
+        fn(K(flipped));
+    }
+};
+
+}  // namespace detail
+
+/* Analyzes Traits::hash over `keys`, which should be distinct. Seeded
+ * traits are given `seed`. At most `avalanche_keys` keys and their first
+ * 256 bits are used for the avalanche test, which hashes once per bit. */
+template <typename Traits, typename K>
+HashReport analyze_hash(const std::vector<K>& keys, std::uint64_t seed = 0,
+                        std::size_t avalanche_keys = 2000) {
+    HashReport report;
+    report.keys = keys.size();
+    if (keys.empty()) return report;
+
+    std::vector<unsigned> hashes;
+    hashes.reserve(keys.size());
+    for (const auto& key : keys) {
+        hashes.push_back(detail::hash_with<Traits>(key, seed));
+    }
+
+    {
+        auto sorted = hashes;
+        std::sort(sorted.begin(), sorted.end());
+        auto unique = std::unique(sorted.begin(), sorted.end());
+        report.hash_collisions =
+            static_cast<std::size_t>(sorted.end() - unique);
+
+        auto n = static_cast<double>(keys.size());
+        report.expected_hash_collisions = n * (n - 1) / 2 / 4294967296.0;
+    }
+
+    // as many buckets as HashTable::reserve() would give the sample
+    constexpr auto load_factor_percent =
+        HashTable<K, Traits>::load_factor_percent;
+    auto capacity = std::max<std::size_t>(
+        4, keys.size() * 100 / load_factor_percent + 1);
+    report.buckets = capacity;
+    auto load = static_cast<double>(keys.size()) /
+                static_cast<double>(capacity);
+
+    {
+        std::vector<std::size_t> per_bucket(capacity);
+        for (auto hash : hashes) ++per_bucket[hash % capacity];
+
+        double chi_square = 0;
+        for (auto count : per_bucket) {
+            auto delta = static_cast<double>(count) - load;
+            chi_square += delta * delta / load;
+        }
+        auto freedom = static_cast<double>(capacity - 1);
+        report.chi_square = chi_square;
+        report.chi_square_z =
+            (chi_square - freedom) / std::sqrt(2 * freedom);
+    }
+
+    // linear probing, exactly as HashTable does it on inserts
+    std::vector<bool> used(capacity);
+    std::size_t hit_probes = 0;
+    for (auto hash : hashes) {
+        auto index = hash % capacity;
+        std::size_t probes = 1;
+        while (used[index]) {
+            index = (index + 1) % capacity;
+            ++probes;
+        }
+        used[index] = true;
+        hit_probes += probes;
+    }
+    report.probe_hit = static_cast<double>(hit_probes) /
+                       static_cast<double>(keys.size());
+
+    {
+        // Knuth's estimates for a uniformly random hash
+        report.expected_probe_hit = (1 + 1 / (1 - load)) / 2;
+        report.expected_probe_miss =
+            (1 + 1 / ((1 - load) * (1 - load))) / 2;
+
+        // Walking backwards from an empty bucket, every used bucket's
+        // distance to the end of its run is what a miss starting there
+        // would probe, and each empty bucket ends a run.
+        std::size_t start = 0;
+        while (used[start]) ++start;
+
+        std::size_t miss_probes = 0, run = 0, runs = 0, used_total = 0;
+        for (std::size_t step = 1; step <= capacity; ++step) {
+            auto index = (start + capacity - step) % capacity;
+            if (used[index]) {
+                ++run;
+                ++used_total;
+                miss_probes += run + 1;
+            } else {
+                if (run) ++runs;
+                report.longest_run = std::max(report.longest_run, run);
+                run = 0;
+                miss_probes += 1;
+            }
+        }
+        if (run) ++runs;
+        report.longest_run = std::max(report.longest_run, run);
+
+        report.probe_miss = static_cast<double>(miss_probes) /
+                            static_cast<double>(capacity);
+        report.mean_run = runs ? static_cast<double>(used_total) /
+                                     static_cast<double>(runs)
+                               : 0;
+        // A run starts after each empty bucket that some key hashes to
+        // the bucket after, so there are about m (1 - a) (1 - e^-a) runs
+        // sharing the a m used buckets.
+        report.expected_mean_run =
+            load / ((1 - load) * (1 - std::exp(-load)));
+    }
+
+    if constexpr (detail::BitFlipper<K>::supported) {
+        using Flipper = detail::BitFlipper<K>;
+        constexpr std::size_t max_bits = 256;
+
+        // flips[bit * 32 + out] counts how often flipping input `bit`
+        // flipped output bit `out`; trials[bit] how often it was tried
+        std::vector<std::size_t> flips(max_bits * 32), trials(max_bits);
+        std::size_t flipped_total = 0, trials_total = 0;
+
+        auto step = std::max<std::size_t>(1, keys.size() / avalanche_keys);
+        for (std::size_t k = 0; k < keys.size(); k += step) {
+            const auto& key = keys[k];
+            auto bits = std::min(Flipper::bits(key), max_bits);
+            for (std::size_t bit = 0; bit < bits; ++bit) {
+                Flipper::with_flipped(key, bit, [&](const K& flipped) {
+                    auto diff = hashes[k] ^
+                                detail::hash_with<Traits>(flipped, seed);
+                    for (int out = 0; out < 32; ++out) {
+                        flips[bit * 32 + out] += (diff >> out) & 1;
+                    }
+                    flipped_total +=
+                        static_cast<std::size_t>(__builtin_popcount(diff));
+                    ++trials[bit];
+                    ++trials_total;
+                });
+            }
+        }
+
+        if (trials_total) {
+            report.avalanche_tested = true;
+            report.avalanche_mean = static_cast<double>(flipped_total) /
+                                    static_cast<double>(trials_total * 32);
+
+            for (std::size_t bit = 0; bit < max_bits; ++bit) {
+                // too few trials to tell bias from noise
+                if (trials[bit] < 100) continue;
+                for (int out = 0; out < 32; ++out) {
+                    auto rate = static_cast<double>(flips[bit * 32 + out]) /
+                                static_cast<double>(trials[bit]);
+                    report.avalanche_worst_bias = std::max(
+                        report.avalanche_worst_bias, std::fabs(rate - 0.5));
+                }
+            }
+        }
+    }
+
+    return report;
+}
+}  // namespace hashfu
@@ -0,0 +1,307 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "DefaultTraits.h"
+
+namespace hashfu {
+
+/* Byte hashing kernels built on hardware instructions, picked at runtime
+ * from what the CPU supports. All of them hash `len` bytes to 64 bits and
+ * read nothing outside [data, data + len).
+ *
+ *   Crc32c   three interleaved SSE4.2 crc32 streams, finalized with fmix64
+ *   Aes      AES-NI rounds over 16-byte blocks, four lanes for long keys
+ *   Avx2     XXH3-style 64-byte stripes of 256-bit multiplies; keys
+ *            shorter than a stripe take the Scalar path
+ *   Scalar   wyhash, the same as DefaultTraits
+ *
+ * The kernels give different hashes for the same bytes, so a table hashed
+ * with AcceleratedTraits on one machine may not match one built on a CPU
+ * with a different feature set. Snapshots notice that and rehash on load()
+ * (see HashTable::save()); FrozenHashMap images are rejected.
+ */
+enum class HashKernel { Scalar, Crc32c, Aes, Avx2 };
+
+namespace detail {
+
+#ifdef HASHFU_X86_KERNELS
+
+__attribute__((target("sse4.2"))) inline std::uint64_t crc32c_hash(
+    const void* data, std::size_t len, std::uint64_t seed) {
+    auto* p = static_cast<const unsigned char*>(data);
+    auto total = len;
+
+    // crc32 has a latency of three cycles, so keep three streams going
+    std::uint64_t a = seed ^ secret[0], b = seed ^ secret[1],
+                  c = seed ^ secret[2];
+    for (; len >= 24; p += 24, len -= 24) {
+        a = _mm_crc32_u64(a, read64(p));
+        b = _mm_crc32_u64(b, read64(p + 8));
+        c = _mm_crc32_u64(c, read64(p + 16));
+    }
+    for (; len >= 8; p += 8, len -= 8) a = _mm_crc32_u64(a, read64(p));
+    if (len >= 4) {
+        b = _mm_crc32_u32(static_cast<std::uint32_t>(b),
+                          static_cast<std::uint32_t>(read32(p)));
+        p += 4;
+        len -= 4;
+    }
+    for (; len > 0; ++p, --len) {
+        c = _mm_crc32_u8(static_cast<std::uint32_t>(c), *p);
+    }
+
+    return fmix64(((a << 32) | b) ^ (c * secret[3]) ^ total);
+}
+
+// Lambdas don't inherit target attributes, so the kernels' helpers are
+// plain functions carrying the same attribute.
+__attribute__((target("aes,sse2"))) inline __m128i load128(
+    const unsigned char* at) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(at));
+}
+
+__attribute__((target("aes,sse2"))) inline std::uint64_t aes_hash(
+    const void* data, std::size_t len, std::uint64_t seed) {
+    auto* p = static_cast<const unsigned char*>(data);
+
+    const auto key = _mm_set_epi64x(static_cast<long long>(secret[1]),
+                                    static_cast<long long>(secret[0] ^ seed));
+    auto state = _mm_xor_si128(
+        key, _mm_set_epi64x(static_cast<long long>(len),
+                            static_cast<long long>(seed)));
+
+    auto remaining = len;
+    if (remaining >= 64) {
+        auto s1 = _mm_xor_si128(state, _mm_set1_epi64x(
+                                           static_cast<long long>(secret[2])));
+        auto s2 = _mm_xor_si128(state, _mm_set1_epi64x(
+                                           static_cast<long long>(secret[3])));
+        auto s3 = _mm_xor_si128(s1, s2);
+        for (; remaining >= 64; p += 64, remaining -= 64) {
+            state = _mm_aesenc_si128(state, load128(p));
+            s1 = _mm_aesenc_si128(s1, load128(p + 16));
+            s2 = _mm_aesenc_si128(s2, load128(p + 32));
+            s3 = _mm_aesenc_si128(s3, load128(p + 48));
+        }
+        state = _mm_aesenc_si128(state, s1);
+        s2 = _mm_aesenc_si128(s2, s3);
+        state = _mm_aesenc_si128(state, s2);
+    }
+    for (; remaining >= 16; p += 16, remaining -= 16) {
+        state = _mm_aesenc_si128(state, load128(p));
+    }
+    if (remaining > 0) {
+        __m128i last;
+        if (len >= 16) {
+            // the final 16 bytes of the key, overlapping ones already seen
+            last = load128(p - (16 - remaining));
+        } else {
+            // two overlapping reads like hash_bytes(); the length is already
+            // in the state, so the overlap loses nothing
+            std::uint64_t lo, hi;
+            if (len >= 8) {
+                lo = read64(p);
+                hi = read64(p + len - 8);
+            } else if (len >= 4) {
+                lo = read32(p);
+                hi = read32(p + len - 4);
+            } else {
+                lo = read_small(p, len);
+                hi = 0;
+            }
+            last = _mm_set_epi64x(static_cast<long long>(hi),
+                                  static_cast<long long>(lo));
+        }
+        state = _mm_aesenc_si128(state, last);
+    }
+
+    state = _mm_aesenc_si128(state, key);
+    state = _mm_aesenc_si128(state, key);
+    state = _mm_aesenclast_si128(state, key);
+    auto lo = static_cast<std::uint64_t>(_mm_cvtsi128_si64(state));
+    auto hi = static_cast<std::uint64_t>(
+        _mm_cvtsi128_si64(_mm_unpackhi_epi64(state, state)));
+    return lo ^ hi;
+}
+
+__attribute__((target("avx2"))) inline __m256i load256(
+    const unsigned char* at) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(at));
+}
+
+// acc += lo32(d ^ key) * hi32(d ^ key) + d with its 64-bit halves swapped
+__attribute__((target("avx2"))) inline __m256i accumulate256(__m256i acc,
+                                                             __m256i d,
+                                                             __m256i key) {
+    auto dk = _mm256_xor_si256(d, key);
+    auto product = _mm256_mul_epu32(dk, _mm256_srli_epi64(dk, 32));
+    auto swapped = _mm256_shuffle_epi32(d, _MM_SHUFFLE(1, 0, 3, 2));
+    return _mm256_add_epi64(acc, _mm256_add_epi64(product, swapped));
+}
+
+__attribute__((target("avx2"))) inline __m256i seeded256(std::uint64_t seed,
+                                                         int a, int b, int c,
+                                                         int d) {
+    return _mm256_set_epi64x(static_cast<long long>(secret[a] ^ seed),
+                             static_cast<long long>(secret[b] + seed),
+                             static_cast<long long>(secret[c] ^ seed),
+                             static_cast<long long>(secret[d] - seed));
+}
+
+__attribute__((target("avx2"))) inline std::uint64_t avx2_hash(
+    const void* data, std::size_t len, std::uint64_t seed) {
+    constexpr std::size_t stripe = 64;
+    if (len < stripe) return hash_bytes(data, len, seed);
+
+    auto* p = static_cast<const unsigned char*>(data);
+    const auto key0 = seeded256(seed, 0, 1, 2, 3);
+    const auto key1 = seeded256(seed, 3, 2, 1, 0);
+    auto acc0 = seeded256(seed, 1, 3, 0, 2);
+    auto acc1 = seeded256(seed, 2, 0, 3, 1);
+
+    auto remaining = len;
+    for (; remaining >= stripe; p += stripe, remaining -= stripe) {
+        acc0 = accumulate256(acc0, load256(p), key0);
+        acc1 = accumulate256(acc1, load256(p + 32), key1);
+    }
+    if (remaining > 0) {
+        // the final stripe of the key, overlapping the one before
+        p -= stripe - remaining;
+        acc0 = accumulate256(acc0, load256(p), key1);
+        acc1 = accumulate256(acc1, load256(p + 32), key0);
+    }
+
+    auto low = _mm256_castsi256_si128(acc0);
+    auto high = _mm256_extracti128_si256(acc0, 1);
+    auto low1 = _mm256_castsi256_si128(acc1);
+    auto high1 = _mm256_extracti128_si256(acc1, 1);
+
+    std::uint64_t h = len * secret[0];
+    for (auto lane : {low, high, low1, high1}) {
+        h += mum_fold(
+            static_cast<std::uint64_t>(_mm_cvtsi128_si64(lane)) ^ secret[1],
+            static_cast<std::uint64_t>(_mm_extract_epi64(lane, 1)) ^
+                secret[2]);
+    }
+    return fmix64(h);
+}
+
+#endif  // HASHFU_X86_KERNELS
+
+using HashKernelFn = std::uint64_t (*)(const void*, std::size_t,
+                                       std::uint64_t);
+
+inline std::uint64_t scalar_hash(const void* data, std::size_t len,
+                                 std::uint64_t seed) {
+    return hash_bytes(data, len, seed);
+}
+
+inline HashKernelFn kernel_function(HashKernel kernel) {
+    switch (kernel) {
+#ifdef HASHFU_X86_KERNELS
+        case HashKernel::Crc32c:
+            return crc32c_hash;
+        case HashKernel::Aes:
+            return aes_hash;
+        case HashKernel::Avx2:
+            return avx2_hash;
+#endif
+        default:
+            return scalar_hash;
+    }
+}
+
+}  // namespace detail
+
+// Whether this CPU can run `kernel`.
+inline bool hash_kernel_supported(HashKernel kernel) {
+#ifdef HASHFU_X86_KERNELS
+    switch (kernel) {
+        case HashKernel::Scalar:
+            return true;
+        case HashKernel::Crc32c:
+            return __builtin_cpu_supports("sse4.2");
+        case HashKernel::Aes:
+            return __builtin_cpu_supports("aes");
+        case HashKernel::Avx2:
+            return __builtin_cpu_supports("avx2");
+    }
+    return false;
+#else
+    return kernel == HashKernel::Scalar;
+#endif
+}
+
+/* The kernel AcceleratedTraits uses on this CPU, chosen once: AES-NI mixes
+ * best per cycle, then CRC32C, then AVX2, then the scalar code. */
+inline HashKernel selected_hash_kernel() {
+    static const HashKernel kernel = [] {
+        for (auto k :
+             {HashKernel::Aes, HashKernel::Crc32c, HashKernel::Avx2}) {
+            if (hash_kernel_supported(k)) return k;
+        }
+        return HashKernel::Scalar;
+    }();
+    return kernel;
+}
+
+// Hashes `len` bytes with `kernel`, which must be supported by this CPU.
+inline std::uint64_t hash_bytes_with(HashKernel kernel, const void* data,
+                                     std::size_t len, std::uint64_t seed = 0) {
+    return detail::kernel_function(kernel)(data, len, seed);
+}
+
+// Hashes `len` bytes with selected_hash_kernel().
+inline std::uint64_t accelerated_hash_bytes(const void* data,
+                                            std::size_t len,
+                                            std::uint64_t seed = 0) {
+    static const detail::HashKernelFn fn =
+        detail::kernel_function(selected_hash_kernel());
+    return fn(data, len, seed);
+}
+
+/* Traits hashing with selected_hash_kernel(), for strings and for keys
+ * whose bytes are their value: trivially copyable, padding-free types such
+ * as integers or fixed-size byte arrays. */
+template <typename T, typename = void>
+struct AcceleratedTraits;
+
+template <>
+struct AcceleratedTraits<std::string_view> {
+    static unsigned hash(std::string_view value) {
+        return detail::fold(
+            accelerated_hash_bytes(value.data(), value.size()));
+    }
+    static unsigned hash(std::string_view value, std::uint64_t seed) {
+        return detail::fold(
+            accelerated_hash_bytes(value.data(), value.size(), seed));
+    }
+    static bool equals(std::string_view a, std::string_view b) {
+        return a == b;
+    }
+};
+
+template <>
+struct AcceleratedTraits<std::string> : AcceleratedTraits<std::string_view> {
+};
+
+template <typename T>
+struct AcceleratedTraits<
+    T, std::enable_if_t<std::is_trivially_copyable_v<T> &&
+                        std::has_unique_object_representations_v<T>>> {
+    static constexpr bool bitwise_equals = true;
+
+    static unsigned hash(const T& value) {
+        return detail::fold(accelerated_hash_bytes(&value, sizeof(T)));
+    }
+    static bool equals(const T& a, const T& b) {
+        return detail::bytes_equal<sizeof(T)>(&a, &b);
+    }
+};
+}  // namespace hashfu
@@ -1,23 +1,90 @@
 #pragma once
 
+#include <algorithm>
+#include <cassert>
 #include <cstddef>
+#include <cstdint>
+#include <type_traits>
 
 #include "HashTable.h"
 
 namespace hashfu {
-template <typename K, typename V, typename KeyTraits>
+
+namespace detail {
+
+/* Gives a map's entry traits a hash_batch() when its key traits have one,
+ * so that rehashing the map hashes keys a group at a time too. */
+template <typename Entry, typename K, typename KeyTraits, typename = void>
+struct EntryHashBatch {};
+
+template <typename Entry, typename K, typename KeyTraits>
+struct EntryHashBatch<Entry, K, KeyTraits,
+                      std::enable_if_t<has_hash_batch_v<KeyTraits, K> &&
+                                       std::is_trivially_copyable_v<K> &&
+                                       std::is_default_constructible_v<K>>> {
+    static void hash_batch(const Entry* entries, std::size_t n,
+                           unsigned* out) {
+        constexpr std::size_t group = 16;
+        K keys[group];
+
+        for (std::size_t first = 0; first < n; first += group) {
+            auto count = std::min(group, n - first);
+            for (std::size_t i = 0; i < count; ++i) {
+                keys[i] = entries[first + i].key;
+            }
+            KeyTraits::hash_batch(keys, count, out + first);
+        }
+    }
+};
+
+/* Entry hashing of a map: KeyTraits::hash of the key, and the seeded
+ * overload as well when KeyTraits has one. */
+template <typename Entry, typename K, typename KeyTraits, typename = void>
+struct EntryHash {
+    static unsigned hash(const Entry& e) { return KeyTraits::hash(e.key); }
+};
+
+template <typename Entry, typename K, typename KeyTraits>
+struct EntryHash<Entry, K, KeyTraits,
+                 std::enable_if_t<has_seeded_hash_v<KeyTraits, K>>> {
+    static unsigned hash(const Entry& e) { return KeyTraits::hash(e.key); }
+    static unsigned hash(const Entry& e, std::uint64_t seed) {
+        return KeyTraits::hash(e.key, seed);
+    }
+};
+
+}  // namespace detail
+
+/* `Table` stores the map's entries: HashTable by default, or any class
+ * template with its API that takes the entry type and its traits, such as
+ * HopscotchTable or CuckooTable. Tables with further non-type parameters
+ * need such an alias to fix them. Snapshots need a table that has them. */
+template <typename K, typename V, typename KeyTraits = DefaultTraits<K>,
+          template <typename...> class Table = HashTable>
 class HashMap {
     struct Entry {
         K key;
         V value;
     };
-    struct EntryTraits {
-        static unsigned hash(const Entry& e) { return KeyTraits::hash(e.key); }
+    struct EntryTraits : detail::EntryHash<Entry, K, KeyTraits>,
+                         detail::EntryHashBatch<Entry, K, KeyTraits> {
         static bool equals(const Entry& a, const Entry& b) {
             return KeyTraits::equals(a.key, b.key);
         }
     };
-    using HashTableType = HashTable<Entry, EntryTraits>;
+    // adapts a serializer for K and V to HashTable's entry serializer
+    template <typename Serializer>
+    struct EntrySerializer {
+        static void write(std::ostream& os, const Entry& e) {
+            Serializer::write(os, e.key);
+            Serializer::write(os, e.value);
+        }
+        static void read(std::istream& is, Entry& e) {
+            Serializer::read(is, e.key);
+            Serializer::read(is, e.value);
+        }
+    };
+    using HashTableType = Table<Entry, EntryTraits>;
     using IteratorType = typename HashTableType::Iterator;
     using ConstIteratorType = typename HashTableType::ConstIterator;
 
@@ -25,6 +92,9 @@ class HashMap {
     HashTableType table_;
 
    public:
+    using Iterator = IteratorType;
+    using ConstIterator = ConstIteratorType;
+
     HashMap() = default;
 
     [[nodiscard]] bool empty() const { return table_.empty(); }
@@ -33,38 +103,92 @@ class HashMap {
     float load_factor() const { return table_.load_factor(); }
 
     void clear() { table_.clear(); }
+    void reserve(size_t count) { table_.reserve(count); }
 
     ConstIteratorType begin() const noexcept { return table_.begin(); }
     ConstIteratorType cbegin() const noexcept { return begin(); }
     ConstIteratorType end() const noexcept { return table_.end(); }
     ConstIteratorType cend() const noexcept { return end(); }
 
+    /* Hash of `key` as used by this map. Callers that look up the same key
+     * repeatedly, or in several maps, can compute it once and pass it to
+     * the *_with_hash overloads below.
+     *
+     * With KeyTraits that take a seed the hash depends on the map's seed(),
+     * which is random per map and changes when an insert reseeds it (see
+     * HashTable::lookup_for_writing()). hash_key() is a member then, and
+     * its result is only good for this map until the next insert; sharing
+     * hashes between maps takes unseeded KeyTraits. */
+    template <typename Traits = KeyTraits,
+              std::enable_if_t<!detail::has_seeded_hash_v<Traits, K>, int> = 0>
+    static unsigned hash_key(const K& key) {
+        return KeyTraits::hash(key);
+    }
+    template <typename Traits = KeyTraits,
+              std::enable_if_t<detail::has_seeded_hash_v<Traits, K>, int> = 0>
+    unsigned hash_key(const K& key) const {
+        return KeyTraits::hash(key, table_.seed());
+    }
+    // 0 for KeyTraits without a seed
+    std::uint64_t seed() const { return table_.seed(); }
+
     ConstIteratorType find(const K& key) const {
-        return table_.find(KeyTraits::hash(key), [&](auto& entry) {
+        return find(key, hash_key(key));
+    }
+    // `hash` must be this map's hash_key(key), taken since its last insert
+    ConstIteratorType find(const K& key, unsigned hash) const {
+        assert(hash == hash_key(key));
+        return table_.find(hash, [&](auto& entry) {
             return KeyTraits::equals(key, entry.key);
         });
     }
-    template <typename Pred>
+    template <typename Pred, typename = std::enable_if_t<
+                                 std::is_invocable_v<Pred&, const Entry&>>>
     ConstIteratorType find(unsigned hash, Pred predicate) const {
         return table_.find(hash, predicate);
     }
 
     IteratorType begin() noexcept { return table_.begin(); }
     IteratorType end() noexcept { return table_.end(); }
-    IteratorType find(const K& key) {
-        return table_.find(KeyTraits::hash(key), [&](auto& entry) {
+    IteratorType find(const K& key) { return find(key, hash_key(key)); }
+    IteratorType find(const K& key, unsigned hash) {
+        assert(hash == hash_key(key));
+        return table_.find(hash, [&](auto& entry) {
             return KeyTraits::equals(key, entry.key);
         });
     }
-    template <typename Pred>
+    template <typename Pred, typename = std::enable_if_t<
+                                 std::is_invocable_v<Pred&, const Entry&>>>
     IteratorType find(unsigned hash, Pred predicate) {
         return table_.find(hash, predicate);
     }
 
     bool contains(const K& key) const { return find(key) != end(); }
 
-    bool remove(const K& key) {
-        auto it = find(key);
+    // Batched lookups: out[i] receives the result for keys[i].
+    void find_batch(const K* keys, size_t n, ConstIteratorType* out) const {
+        table_.template for_each_hashed<KeyTraits>(
+            keys, n, [&](size_t i, unsigned hash) {
+                out[i] = find(keys[i], hash);
+            });
+    }
+    void find_batch(const K* keys, size_t n, IteratorType* out) {
+        table_.template for_each_hashed<KeyTraits>(
+            keys, n, [&](size_t i, unsigned hash) {
+                out[i] = find(keys[i], hash);
+            });
+    }
+    void contains_batch(const K* keys, size_t n, bool* out) const {
+        table_.template for_each_hashed<KeyTraits>(
+            keys, n, [&](size_t i, unsigned hash) {
+                out[i] = find(keys[i], hash) != end();
+            });
+    }
+
+    bool remove(const K& key) { return remove_with_hash(key, hash_key(key)); }
+    // as for find(key, hash)
+    bool remove_with_hash(const K& key, unsigned hash) {
+        auto it = find(key, hash);
         if (it != end()) {
             table_.remove(it);
             return true;
@@ -77,13 +201,84 @@ class HashMap {
      * table_.insert().
      * This can be done only after HashTable implements forwarding references*/
     HashTableResult insert(const K& key, const V& value) {
-        return table_.insert({key, value});
+        return insert_with_hash(key, hash_key(key), value);
+    }
+    // as for find(key, hash)
+    HashTableResult insert_with_hash(const K& key, unsigned hash,
+                                     const V& value) {
+        assert(hash == hash_key(key));
+        return table_.insert_with_hash(hash, {key, value});
+    }
+
+    /* Inserts keys[i] -> values[i] for i in [0, n), writing each outcome to
+     * results[i]. Existing values are overwritten, just like insert(). */
+    void insert_batch(const K* keys, const V* values, size_t n,
+                      HashTableResult* results) {
+        table_.reserve(size() + n);
+        table_.template for_each_hashed<KeyTraits>(
+            keys, n, [&](size_t i, unsigned hash) {
+                results[i] = insert_with_hash(keys[i], hash, values[i]);
+            });
+    }
+
+    /* Like insert_batch(), but when keys[i] is already present its value is
+     * combined with values[i] instead. `combine` is called as
+     * combine(V& existing, const V& value) and either updates `existing` in
+     * place and returns void, or returns the new value, which is assigned
+     * to it. */
+    template <typename Combine>
+    void upsert_batch(const K* keys, const V* values, size_t n,
+                      Combine combine, HashTableResult* results) {
+        using Combined = std::invoke_result_t<Combine&, V&, const V&>;
+        static_assert(std::is_void_v<Combined> ||
+                          std::is_assignable_v<V&, Combined>,
+                      "combine must return void or a value for V");
+
+        table_.reserve(size() + n);
+        table_.template for_each_hashed<KeyTraits>(
+            keys, n, [&](size_t i, unsigned hash) {
+                auto it = find(keys[i], hash);
+
+                if (it != end()) {
+                    if constexpr (std::is_void_v<Combined>) {
+                        combine(it->value, values[i]);
+                    } else {
+                        it->value = combine(it->value, values[i]);
+                    }
+                    results[i] = HashTableResult::ReplacedExistingEntry;
+                } else {
+                    results[i] = insert_with_hash(keys[i], hash, values[i]);
+                }
+            });
     }
 
-    V& operator[](const K& key) {
-        auto it = find(key);
-        if (it == end()) insert(key, V());
-        return find(key)->value;
+    /* Snapshots, see HashTable::save() and HashTable::load(). The default
+     * serializer needs trivially copyable K and V; otherwise pass one
+     * providing write(std::ostream&, const X&) and read(std::istream&, X&)
+     * for both X = K and X = V. */
+    bool save(std::ostream& os) const { return table_.save(os); }
+    template <typename Serializer>
+    bool save(std::ostream& os) const {
+        return table_.template save<EntrySerializer<Serializer>>(os);
+    }
+    bool load(std::istream& is) { return table_.load(is); }
+    template <typename Serializer>
+    bool load(std::istream& is) {
+        return table_.template load<EntrySerializer<Serializer>>(is);
+    }
+
+    V& operator[](const K& key) { return find_or_insert(key, hash_key(key)); }
+    // operator[] for a precomputed hash, as for find(key, hash)
+    V& find_or_insert(const K& key, unsigned hash) {
+        auto it = find(key, hash);
+        if (it == end()) {
+            insert_with_hash(key, hash, V());
+            // inserting may have reseeded the map
+            if constexpr (detail::has_seeded_hash_v<KeyTraits, K>) {
+                hash = hash_key(key);
+            }
+        }
+        return find(key, hash)->value;
     }
 };
 }  // namespace hashfu
@@ -1,23 +1,439 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <limits>
+#include <random>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "DefaultTraits.h"
 
 namespace hashfu {
 
-enum class HashTableResult { InsertedNewEntry, ReplacedExistingEntry };
+namespace detail {
+
+// whether Traits has the optional
+//     static void hash_batch(const Key*, size_t n, unsigned* out);
+template <typename Traits, typename Key, typename = void>
+struct has_hash_batch : std::false_type {};
+template <typename Traits, typename Key>
+struct has_hash_batch<
+    Traits, Key,
+    std::void_t<decltype(Traits::hash_batch(
+        std::declval<const Key*>(), std::size_t{}, std::declval<unsigned*>()))>>
+    : std::true_type {};
+template <typename Traits, typename Key>
+constexpr bool has_hash_batch_v = has_hash_batch<Traits, Key>::value;
+
+// whether Traits has the optional
+//     static unsigned hash(const Key&, std::uint64_t seed);
+template <typename Traits, typename Key, typename = void>
+struct has_seeded_hash : std::false_type {};
+template <typename Traits, typename Key>
+struct has_seeded_hash<Traits, Key,
+                       std::void_t<decltype(Traits::hash(
+                           std::declval<const Key&>(), std::uint64_t{}))>>
+    : std::true_type {};
+template <typename Traits, typename Key>
+constexpr bool has_seeded_hash_v = has_seeded_hash<Traits, Key>::value;
+
+// Traits::hash(key, seed) if Traits takes a seed, else Traits::hash(key)
+template <typename Traits, typename Key>
+unsigned hash_with(const Key& key, std::uint64_t seed) {
+    if constexpr (has_seeded_hash_v<Traits, Key>) {
+        return Traits::hash(key, seed);
+    } else {
+        return Traits::hash(key);
+    }
+}
+
+/* The loop behind HashTable::for_each_hashed(), for any table with
+ * seed() and prefetch(hash): keys are hashed Batch at a time, through
+ * KeyTraits::hash_batch() when the traits have one and take no seed, and
+ * the group's buckets prefetched before any of them is visited. A visit
+ * that inserts may reseed the table, which leaves the hashes of the rest
+ * of the group stale; they are hashed again with the new seed. */
+template <typename KeyTraits, std::size_t Batch, typename Table, typename Key,
+          typename Visitor>
+void for_each_hashed(const Table& table, const Key* keys, std::size_t n,
+                     Visitor visit) {
+    constexpr bool seeded = has_seeded_hash_v<KeyTraits, Key>;
+    unsigned hashes[Batch];
+
+    auto hash_group = [&](std::size_t first, std::size_t from,
+                          std::size_t count) {
+        for (std::size_t i = from; i < count; ++i) {
+            hashes[i] = hash_with<KeyTraits>(keys[first + i], table.seed());
+            table.prefetch(hashes[i]);
+        }
+    };
+
+    for (std::size_t first = 0; first < n; first += Batch) {
+        auto count = std::min(Batch, n - first);
 
+        if constexpr (!seeded && has_hash_batch_v<KeyTraits, Key>) {
+            KeyTraits::hash_batch(keys + first, count, hashes);
+            for (std::size_t i = 0; i < count; ++i) table.prefetch(hashes[i]);
+        } else {
+            hash_group(first, 0, count);
+        }
+
+        auto seed = table.seed();
+        for (std::size_t i = 0; i < count; ++i) {
+            visit(first + i, hashes[i]);
+
+            if constexpr (seeded) {
+                if (table.seed() != seed) {
+                    seed = table.seed();
+                    hash_group(first, i + 1, count);
+                }
+            }
+        }
+    }
+}
+
+/* A fresh seed for every table with seeded traits: a per-process secret
+ * from std::random_device, stepped by a counter and mixed, so that seeds
+ * can't be guessed from outside the process. */
+inline std::uint64_t new_table_seed() {
+    static const std::uint64_t secret = [] {
+        std::random_device device;
+        return (std::uint64_t{device()} << 32) | device();
+    }();
+    static std::atomic<std::uint64_t> counter{0};
+
+    auto n = counter.fetch_add(1, std::memory_order_relaxed);
+    return fmix64(secret + n * 0x9e3779b97f4a7c15ull);
+}
+
+/* Linear probing over buckets with HashTable's `used` and `deleted` flags,
+ * for HashTable and the maps that lay their buckets out differently
+ * (SoAHashMap), so that all of them probe, reuse tombstones and grow the
+ * same way. */
+constexpr std::size_t probing_load_factor_percent = 60;
+
+/* Whether a table with `used_buckets` buckets in use, tombstones counted,
+ * grows before taking one more entry. */
+constexpr bool probing_should_grow(std::size_t used_buckets,
+                                   std::size_t capacity) {
+    return (used_buckets + 1) * 100 >=
+           capacity * probing_load_factor_percent;
+}
+
+// Whether `count` entries and `deleted` tombstones fit in `capacity`.
+constexpr bool probing_fits(std::size_t count, std::size_t deleted,
+                            std::size_t capacity) {
+    return (count + deleted) * 100 < capacity * probing_load_factor_percent;
+}
+
+// Capacity that fits `count` entries, for reserve().
+constexpr std::size_t probing_capacity_for(std::size_t count) {
+    return count * 100 / probing_load_factor_percent + 1;
+}
+
+/* Index of the first used bucket from `home` on that `matches`, or
+ * `capacity` if an empty bucket ends the probe first. */
+template <typename Bucket, typename Match>
+std::size_t probe_find(const Bucket* buckets, std::size_t capacity,
+                       std::size_t home, Match matches) {
+    for (auto index = home;; index = index + 1 == capacity ? 0 : index + 1) {
+        const auto& bucket = buckets[index];
+
+        if (bucket.used && matches(bucket)) return index;
+
+        if (!bucket.used && !bucket.deleted) return capacity;
+    }
+}
+
+/* Index of the used bucket from `home` on that `matches`, or else of the
+ * first unused one on the probe, tombstones included. `probes` receives
+ * the number of buckets looked at. */
+template <typename Bucket, typename Match>
+std::size_t probe_for_insert(const Bucket* buckets, std::size_t capacity,
+                             std::size_t home, Match matches,
+                             std::size_t& probes) {
+    auto first_unused = capacity;
+    probes = 1;
+    for (auto index = home;; index = index + 1 == capacity ? 0 : index + 1) {
+        const auto& bucket = buckets[index];
+
+        if (bucket.used && matches(bucket)) return index;
+
+        if (!bucket.used) {
+            if (first_unused == capacity) first_unused = index;
+
+            if (!bucket.deleted) return first_unused;
+        }
+        ++probes;
+    }
+}
+
+// whether Traits declares static constexpr bool bitwise_equals = true
+template <typename Traits, typename = void>
+struct has_bitwise_equals : std::false_type {};
+template <typename Traits>
+struct has_bitwise_equals<Traits,
+                          std::void_t<decltype(Traits::bitwise_equals)>>
+    : std::bool_constant<Traits::bitwise_equals> {};
+template <typename Traits>
+constexpr bool has_bitwise_equals_v = has_bitwise_equals<Traits>::value;
+
+/* What a probe looks for in buckets made of Words 64-bit words: a bucket
+ * holds the key when every word w has (w & match_mask[i]) == match_bits[i],
+ * and ends the probe when (w & empty_mask[i]) == empty_bits[i] for all of
+ * them. See HashTable::lookup_for_reading(). */
+struct ProbeWords {
+    std::uint64_t match_mask[2], match_bits[2];
+    std::uint64_t empty_mask[2], empty_bits[2];
+};
+
+// bit 0: the bucket at `at` holds the key; bit 1: it ends the probe
+template <std::size_t Words>
+inline unsigned probe_bucket(const unsigned char* at, const ProbeWords& p) {
+    bool match = true, empty = true;
+    for (std::size_t i = 0; i < Words; ++i) {
+        std::uint64_t word;
+        std::memcpy(&word, at + i * 8, 8);
+        match &= (word & p.match_mask[i]) == p.match_bits[i];
+        empty &= (word & p.empty_mask[i]) == p.empty_bits[i];
+    }
+    return unsigned(match) | unsigned(empty) << 1;
+}
+
+// One bit per word to one bit per bucket, at the bucket's first word.
+template <std::size_t Words>
+constexpr unsigned whole_buckets(unsigned bits) {
+    return Words == 1 ? bits : bits & (bits >> 1) & 0x55;
+}
+
+#ifdef HASHFU_X86_KERNELS
+
+// Lambdas don't inherit target attributes, hence these helpers: they
+// spread the pattern for one bucket over a whole register.
+template <std::size_t Words>
+__attribute__((target("avx2"))) inline __m256i probe_lanes256(
+    const std::uint64_t* words) {
+    return _mm256_set_epi64x(static_cast<long long>(words[3 % Words]),
+                             static_cast<long long>(words[2 % Words]),
+                             static_cast<long long>(words[1 % Words]),
+                             static_cast<long long>(words[0]));
+}
+
+template <std::size_t Words>
+__attribute__((target("avx512f"))) inline __m512i probe_lanes512(
+    const std::uint64_t* words) {
+    return _mm512_set_epi64(static_cast<long long>(words[7 % Words]),
+                            static_cast<long long>(words[6 % Words]),
+                            static_cast<long long>(words[5 % Words]),
+                            static_cast<long long>(words[4 % Words]),
+                            static_cast<long long>(words[3 % Words]),
+                            static_cast<long long>(words[2 % Words]),
+                            static_cast<long long>(words[1 % Words]),
+                            static_cast<long long>(words[0]));
+}
+
+/* Linear probes from `index` over `capacity` buckets of Words words, for
+ * ProbeWords `p`. Returns the index of the bucket holding the key, or
+ * `capacity` if an empty bucket comes first. A group of buckets is tested
+ * with one compare per pattern: four words with AVX2, eight with
+ * AVX-512; buckets where a group would run past the end of the table are
+ * tested one at a time. */
+template <std::size_t Words>
+__attribute__((target("avx2"))) std::size_t probe_avx2(
+    const unsigned char* buckets, std::size_t capacity, std::size_t index,
+    const ProbeWords& p) {
+    constexpr std::size_t group = 4 / Words;
+    const auto match_mask = probe_lanes256<Words>(p.match_mask);
+    const auto match_bits = probe_lanes256<Words>(p.match_bits);
+    const auto empty_mask = probe_lanes256<Words>(p.empty_mask);
+    const auto empty_bits = probe_lanes256<Words>(p.empty_bits);
+
+    for (;;) {
+        auto start = index - index % group;
+        if (start + group > capacity) {
+            auto found = probe_bucket<Words>(buckets + index * Words * 8, p);
+            if (found) return found & 1 ? index : capacity;
+            index = index + 1 == capacity ? 0 : index + 1;
+            continue;
+        }
+
+        auto v = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(buckets + start * Words * 8));
+        auto match = whole_buckets<Words>(
+            static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(
+                _mm256_cmpeq_epi64(_mm256_and_si256(v, match_mask),
+                                   match_bits)))));
+        auto empty = whole_buckets<Words>(
+            static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(
+                _mm256_cmpeq_epi64(_mm256_and_si256(v, empty_mask),
+                                   empty_bits)))));
+        // buckets before `index` belong to some other probe
+        auto skipped = static_cast<unsigned>((index - start) * Words);
+        match >>= skipped;
+        empty >>= skipped;
+        if (auto hit = match | empty) {
+            auto first = static_cast<unsigned>(__builtin_ctz(hit));
+            return (match >> first) & 1 ? index + first / Words : capacity;
+        }
+        index = start + group;
+        if (index == capacity) index = 0;
+    }
+}
+
+template <std::size_t Words>
+__attribute__((target("avx512f"))) std::size_t probe_avx512(
+    const unsigned char* buckets, std::size_t capacity, std::size_t index,
+    const ProbeWords& p) {
+    constexpr std::size_t group = 8 / Words;
+    const auto match_mask = probe_lanes512<Words>(p.match_mask);
+    const auto match_bits = probe_lanes512<Words>(p.match_bits);
+    const auto empty_mask = probe_lanes512<Words>(p.empty_mask);
+    const auto empty_bits = probe_lanes512<Words>(p.empty_bits);
+
+    for (;;) {
+        auto start = index - index % group;
+        if (start + group > capacity) {
+            auto found = probe_bucket<Words>(buckets + index * Words * 8, p);
+            if (found) return found & 1 ? index : capacity;
+            index = index + 1 == capacity ? 0 : index + 1;
+            continue;
+        }
+
+        auto v = _mm512_loadu_si512(buckets + start * Words * 8);
+        auto match = whole_buckets<Words>(_mm512_cmpeq_epi64_mask(
+            _mm512_and_si512(v, match_mask), match_bits));
+        auto empty = whole_buckets<Words>(_mm512_cmpeq_epi64_mask(
+            _mm512_and_si512(v, empty_mask), empty_bits));
+        // buckets before `index` belong to some other probe
+        auto skipped = static_cast<unsigned>((index - start) * Words);
+        match >>= skipped;
+        empty >>= skipped;
+        if (auto hit = match | empty) {
+            auto first = static_cast<unsigned>(__builtin_ctz(hit));
+            return (match >> first) & 1 ? index + first / Words : capacity;
+        }
+        index = start + group;
+        if (index == capacity) index = 0;
+    }
+}
+
+#endif  // HASHFU_X86_KERNELS
+
+template <std::size_t Words>
+using ProbeKernel = std::size_t (*)(const unsigned char*, std::size_t,
+                                    std::size_t, const ProbeWords&);
+
+// The widest probe kernel this CPU supports, picked on first use; nullptr
+// if it has none, and probes should take the plain loop.
+template <std::size_t Words>
+ProbeKernel<Words> probe_kernel() {
+    static const ProbeKernel<Words> kernel = []() -> ProbeKernel<Words> {
+#ifdef HASHFU_X86_KERNELS
+        if (__builtin_cpu_supports("avx512f")) return probe_avx512<Words>;
+        if (__builtin_cpu_supports("avx2")) return probe_avx2<Words>;
+#endif
+        return nullptr;
+    }();
+    return kernel;
+}
+
+}  // namespace detail
+
+enum class HashTableResult {
+    InsertedNewEntry,
+    ReplacedExistingEntry,
+    // only from fixed-capacity maps that ran out of room, see StaticHashMap,
+    // and from CuckooHashTable, HopscotchHashTable and SoAHashMap when they
+    // could not get memory to grow
+    TableFull,
+};
+
+/* Default serializer for HashTable::save()/load(): copies the object
+ * representation. Types that are not trivially copyable need a serializer
+ * with the same two functions, and must be default constructible so that
+ * load() has an object to read() into. */
+template <typename T>
+struct TrivialSerializer {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "T needs a user-supplied serializer");
+
+    static void write(std::ostream& os, const T& value) {
+        os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+    static void read(std::istream& is, T& value) {
+        is.read(reinterpret_cast<char*>(&value), sizeof(T));
+    }
+};
+
+/* Leads every snapshot. Snapshots are meant to be read back by the same
+ * build on the same platform; anything else is rejected or, when only the
+ * hash function changed, loaded by reinserting every entry. */
+struct SnapshotHeader {
+    static constexpr char expected_magic[8] = {'h', 'a', 's', 'h',
+                                               'f', 'u', 's', '\0'};
+    static constexpr std::uint32_t current_version = 2;
+
+    char magic[8];
+    std::uint32_t version;
+    // nonzero if the bucket array was written out verbatim
+    std::uint32_t raw_layout;
+    std::uint64_t capacity;
+    std::uint64_t size;
+    std::uint64_t deleted_count;
+    // the table's seed, which placed the entries for seeded traits
+    std::uint64_t seed;
+    std::uint32_t load_factor_percent;
+    std::uint32_t bucket_size;
+    std::uint32_t value_size;
+    // hashes of a sample of the stored entries, see hash_fingerprint()
+    std::uint32_t fingerprint;
+};
+
+namespace detail {
+
+/* Index of the first bit set at or after `from` in a bitmap of `count`
+ * bits, or `count` if there is none. */
+inline std::size_t next_set_bit(const std::uint64_t* bits, std::size_t count,
+                                std::size_t from) {
+    if (from >= count) return count;
+
+    auto word = from / 64;
+    auto last_word = count / 64;
+    auto current = bits[word] & (~std::uint64_t{0} << (from % 64));
+    while (!current) {
+        if (++word > last_word) return count;
+        current = bits[word];
+    }
+
+    return word * 64 + static_cast<std::size_t>(__builtin_ctzll(current));
+}
+
+}  // namespace detail
+
+/* Iterators hold on to the bucket array and its occupancy bitmap rather
+ * than to the table, so they stay valid when the table is moved or
+ * swapped, and are invalidated by whatever reallocates the buckets. */
 template <typename HashTableType, typename T, typename Bucket>
 class HashTableIterator {
     friend HashTableType;
 
    private:
     Bucket* bucket_{nullptr};  // points to the current bucket
+    Bucket* buckets_{nullptr};
+    const std::uint64_t* occupied_{nullptr};
+    std::size_t capacity_{0};
 
    public:
+    HashTableIterator() = default;
+
     // Basic operator overloads required by any iterator
     friend bool operator==(const HashTableIterator& lhs,
                            const HashTableIterator& rhs) {
@@ -37,20 +453,29 @@ class HashTableIterator {
     void next_used_bucket() {
         if (!bucket_) return;
 
-        do {
-            ++bucket_;
-            if (bucket_->used) return;
-        } while (!bucket_->end);
-
-        if (bucket_->end) bucket_ = nullptr;
+        auto index = detail::next_set_bit(
+            occupied_, capacity_,
+            static_cast<std::size_t>(bucket_ - buckets_) + 1);
+        bucket_ = index < capacity_ ? &buckets_[index] : nullptr;
     }
 
-    explicit HashTableIterator(Bucket* bucket) : bucket_(bucket) {}
+    HashTableIterator(HashTableType* table, Bucket* bucket)
+        : bucket_(bucket),
+          buckets_(table->buckets_),
+          occupied_(table->occupied_),
+          capacity_(table->capacity_) {}
 };
 
-template <typename T, typename TraitsForT>
+template <typename T, typename TraitsForT = DefaultTraits<T>>
 class HashTable {
-    static constexpr size_t load_factor_percent = 60;
+    // CoroLookup.h drives its probes directly on the bucket array
+    template <typename HashTableType>
+    friend class CoroLookup;
+
+    // number of lookups kept in flight by the batch APIs
+    static constexpr size_t batch_size = 16;
+    // whether TraitsForT::hash takes the table's seed
+    static constexpr bool seeded = detail::has_seeded_hash_v<TraitsForT, T>;
 
     struct Bucket {
         bool used;
@@ -64,21 +489,38 @@ class HashTable {
         alignas(T) unsigned char storage[sizeof(T)];
 
         T* slot() { return reinterpret_cast<T*>(storage); }
+        const T* slot() const { return reinterpret_cast<const T*>(storage); }
     };
 
    public:
     using key_type = T;
     using value_type = T;
+    using traits_type = TraitsForT;
     using size_type = std::size_t;
     using difference_type = std::ptrdiff_t;
     using reference = value_type&;
     using const_reference = const value_type&;
 
+    // the table grows before more than this share of buckets is in use,
+    // counting tombstones
+    static constexpr size_t load_factor_percent =
+        detail::probing_load_factor_percent;
+
    private:
     Bucket* buckets_{nullptr};
+    /* One bit per bucket, set while the bucket is used. Iteration scans it
+     * a word at a time, so empty stretches of the table are skipped 64
+     * buckets per step instead of one. */
+    std::uint64_t* occupied_{nullptr};
     size_type size_{0};
     size_type deleted_count_{0};
     size_type capacity_{0};
+    // index of the first used bucket, capacity_ if there is none
+    size_type first_used_{0};
+    // passed to seeded traits; see reseed()
+    std::uint64_t seed_{seeded ? detail::new_table_seed() : 0};
+    // capacity the table last reseeded at; it reseeds once per capacity
+    size_type reseeded_at_{0};
 
    public:
     HashTable() = default;
@@ -109,6 +551,7 @@ class HashTable {
         }
 
         std::free(buckets_);
+        std::free(occupied_);
     }
 
     // copy constructor
@@ -130,11 +573,16 @@ class HashTable {
 
     // move constructor
     HashTable(HashTable&& other) noexcept
-        : size_(other.size_),
+        : buckets_(other.buckets_),
+          occupied_(other.occupied_),
+          size_(other.size_),
+          deleted_count_(other.deleted_count_),
           capacity_(other.capacity_),
-          buckets_(other.buckets_),
-          deleted_count_(other.deleted_count_) {
+          first_used_(other.first_used_),
+          seed_(other.seed_),
+          reseeded_at_(other.reseeded_at_) {
         other.buckets_ = nullptr;
+        other.occupied_ = nullptr;
     }
     // move assignment
     HashTable& operator=(HashTable&& other) noexcept {
@@ -152,6 +600,10 @@ class HashTable {
         std::swap(a.size_, b.size_);
         std::swap(a.deleted_count_, b.deleted_count_);
         std::swap(a.buckets_, b.buckets_);
+        std::swap(a.occupied_, b.occupied_);
+        std::swap(a.first_used_, b.first_used_);
+        std::swap(a.seed_, b.seed_);
+        std::swap(a.reseeded_at_, b.reseeded_at_);
     }
 
     // NOTE: Debug function
@@ -175,59 +627,93 @@ class HashTable {
 
     //  Implement iterator functions
     using Iterator = HashTableIterator<HashTable, T, Bucket>;
-    Iterator begin() noexcept {
-        for (size_t i = 0; i < capacity_; ++i) {
-            if (buckets_[i].used) return Iterator(&buckets_[i]);
-        }
-
-        return end();
-    }
-    Iterator end() noexcept { return Iterator(nullptr); }
+    Iterator begin() noexcept { return iterator_for(first_used_bucket()); }
+    Iterator end() noexcept { return Iterator(this, nullptr); }
 
     using ConstIterator =
         HashTableIterator<const HashTable, const T, const Bucket>;
     ConstIterator begin() const noexcept {
-        for (size_t i = 0; i < capacity_; ++i) {
-            if (buckets_[i].used) return ConstIterator(&buckets_[i]);
-        }
-
-        return end();
+        return iterator_for(first_used_bucket());
     }
     ConstIterator cbegin() const noexcept { return begin(); }
 
-    ConstIterator end() const noexcept { return ConstIterator(nullptr); }
+    ConstIterator end() const noexcept { return ConstIterator(this, nullptr); }
     ConstIterator cend() const noexcept { return end(); }
 
     void clear() { *this = HashTable(); }
 
     template <typename Pred>
     Iterator find(unsigned hash, Pred predicate) {
-        return Iterator(lookup_with_hash(hash, predicate));
+        return iterator_for(lookup_with_hash(hash, predicate));
     }
     template <typename Pred>
     ConstIterator find(unsigned hash, Pred predicate) const {
-        return ConstIterator(lookup_with_hash(hash, predicate));
+        return iterator_for(lookup_with_hash(hash, predicate));
     }
 
     Iterator find(const T& value) {
-        return find(TraitsForT::hash(value), [&value](auto& entry) {
-            return TraitsForT::equals(entry, value);
-        });
+        return iterator_for(lookup_for_reading(hash_of(value), value));
     }
     ConstIterator find(const T& value) const {
-        return find(TraitsForT::hash(value), [&value](auto& entry) {
-            return TraitsForT::equals(entry, value);
-        });
+        return iterator_for(lookup_for_reading(hash_of(value), value));
     }
 
     bool contains(const value_type& value) const {
         return find(value) != end();
     }
 
+    // Batched lookups: out[i] receives the result for values[i].
+    void find_batch(const T* values, size_type n, Iterator* out) {
+        for_each_hashed<TraitsForT>(values, n, [&](size_type i, unsigned hash) {
+            out[i] = iterator_for(lookup_for_reading(hash, values[i]));
+        });
+    }
+    void find_batch(const T* values, size_type n, ConstIterator* out) const {
+        for_each_hashed<TraitsForT>(values, n, [&](size_type i, unsigned hash) {
+            out[i] = iterator_for(lookup_for_reading(hash, values[i]));
+        });
+    }
+    void contains_batch(const T* values, size_type n, bool* out) const {
+        for_each_hashed<TraitsForT>(values, n, [&](size_type i, unsigned hash) {
+            out[i] = lookup_for_reading(hash, values[i]) != nullptr;
+        });
+    }
+
+    /* Hash of `value` in this table: TraitsForT::hash(value), or, for
+     * traits that take a seed, TraitsForT::hash(value, seed()). Seeded
+     * hashes are only good for this table, and only until an insert
+     * reseeds it. */
+    unsigned hash_of(const T& value) const {
+        return detail::hash_with<TraitsForT>(value, seed_);
+    }
+    std::uint64_t seed() const { return seed_; }
+
+    // Pulls the home bucket of `hash` into cache ahead of a lookup.
+    void prefetch(unsigned hash) const {
+        if (!buckets_) return;
+        __builtin_prefetch(&buckets_[hash % capacity_]);
+    }
+
+    /* Building block for the batch APIs. Keys are hashed with KeyTraits a
+     * group at a time and all of the group's home buckets are prefetched
+     * before `visit(index, hash)` is called for any of them, so that the
+     * cache misses of a group overlap instead of being paid one by one.
+     * Seeded KeyTraits get this table's seed; unseeded ones with a
+     * hash_batch() hash the whole group in one call. */
+    template <typename KeyTraits, typename Key, typename Visitor>
+    void for_each_hashed(const Key* keys, size_type n, Visitor visit) const {
+        detail::for_each_hashed<KeyTraits, batch_size>(*this, keys, n, visit);
+    }
+
     /* TODO: Take a forwarding reference for insert and
      * forward it to the constructor of T*/
     HashTableResult insert(const value_type& value) {
-        auto& bucket = lookup_for_writing(value);
+        return insert_with_hash(hash_of(value), value);
+    }
+    // `hash` must be hash_of(value)
+    HashTableResult insert_with_hash(unsigned hash, const value_type& value) {
+        assert(hash == hash_of(value));
+        auto& bucket = lookup_for_writing(hash, value);
 
         if (bucket.used) {
             *bucket.slot() = value;
@@ -235,7 +721,7 @@ class HashTable {
         }
 
         new (bucket.slot()) T(value);
-        bucket.used = true;
+        mark_used(bucket);
         if (bucket.deleted) {
             // if we are reusing a deleted entry, decrease count
             bucket.deleted = false;
@@ -246,6 +732,23 @@ class HashTable {
         return HashTableResult::InsertedNewEntry;
     }
 
+    /* Inserts values[0..n), writing the outcome for values[i] to results[i].
+     * The table is grown once for the whole batch and inserts are issued
+     * a prefetched group at a time. */
+    void insert_batch(const T* values, size_type n, HashTableResult* results) {
+        reserve(size_ + n);
+        for_each_hashed<TraitsForT>(values, n, [&](size_type i, unsigned hash) {
+            results[i] = insert_with_hash(hash, values[i]);
+        });
+    }
+
+    // Grows the table so that `count` entries fit without another rehash.
+    void reserve(size_type count) {
+        if (detail::probing_fits(count, deleted_count_, capacity_)) return;
+
+        rehash(detail::probing_capacity_for(count));
+    }
+
     void remove(Iterator iter) {
         assert(iter.bucket_);
         auto& bucket = *iter.bucket_;
@@ -254,7 +757,7 @@ class HashTable {
         assert(!bucket.end);
 
         bucket.slot()->~T();
-        bucket.used = false;
+        mark_unused(bucket);
         bucket.deleted = true;
         --size_;
         ++deleted_count_;
@@ -269,11 +772,256 @@ class HashTable {
         return false;
     }
 
+    /* Writes a snapshot of the table that load() can restore without
+     * rehashing. With the default serializer the bucket array is written in
+     * one go, otherwise bucket states are written followed by each entry in
+     * turn. Returns false if the stream failed. */
+    bool save(std::ostream& os) const { return save<TrivialSerializer<T>>(os); }
+    template <typename Serializer>
+    bool save(std::ostream& os) const {
+        SnapshotHeader header{};
+        std::copy(std::begin(SnapshotHeader::expected_magic),
+                  std::end(SnapshotHeader::expected_magic), header.magic);
+        header.version = SnapshotHeader::current_version;
+        header.raw_layout = is_raw_serializer<Serializer>();
+        header.capacity = capacity_;
+        header.size = size_;
+        header.deleted_count = deleted_count_;
+        header.seed = seed_;
+        header.load_factor_percent = load_factor_percent;
+        header.bucket_size = sizeof(Bucket);
+        header.value_size = sizeof(T);
+        header.fingerprint = hash_fingerprint();
+        os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        if (!buckets_) return bool(os);
+
+        if constexpr (is_raw_serializer<Serializer>()) {
+            os.write(reinterpret_cast<const char*>(buckets_),
+                     sizeof(Bucket) * (capacity_ + 1));
+            os.write(reinterpret_cast<const char*>(occupied_),
+                     sizeof(std::uint64_t) * occupied_words());
+        } else {
+            for (size_type i = 0; i < capacity_; ++i) {
+                char state = buckets_[i].used | (buckets_[i].deleted << 1);
+                os.put(state);
+            }
+            for (size_type i = 0; i < capacity_; ++i) {
+                if (buckets_[i].used) {
+                    Serializer::write(os, *buckets_[i].slot());
+                }
+            }
+        }
+
+        return bool(os);
+    }
+
+    /* Replaces the contents of the table with a snapshot written by save()
+     * with the same serializer. The table takes the snapshot's seed, and
+     * the bucket layout is reused as is unless the load factor policy or
+     * the hash function differ from the ones the snapshot was taken with,
+     * in which case the entries are reinserted.
+     * Returns false, leaving the table untouched, if the stream is not a
+     * compatible snapshot or its counts, bucket states and bitmap disagree.
+     */
+    bool load(std::istream& is) { return load<TrivialSerializer<T>>(is); }
+    template <typename Serializer>
+    bool load(std::istream& is) {
+        SnapshotHeader header{};
+        if (!is.read(reinterpret_cast<char*>(&header), sizeof(header)))
+            return false;
+
+        if (!std::equal(std::begin(header.magic), std::end(header.magic),
+                        std::begin(SnapshotHeader::expected_magic)) ||
+            header.version != SnapshotHeader::current_version ||
+            header.raw_layout != is_raw_serializer<Serializer>() ||
+            header.value_size != sizeof(T) ||
+            (header.raw_layout && header.bucket_size != sizeof(Bucket)) ||
+            !counts_valid(header)) {
+            return false;
+        }
+
+        HashTable loaded;
+        // entries sit where the saved seed put them
+        if constexpr (seeded) loaded.seed_ = header.seed;
+        if (header.capacity == 0) {
+            swap(*this, loaded);
+            return true;
+        }
+
+        auto capacity = static_cast<size_type>(header.capacity);
+        if (!loaded.allocate(capacity)) return false;
+
+        if constexpr (is_raw_serializer<Serializer>()) {
+            is.read(reinterpret_cast<char*>(loaded.buckets_),
+                    sizeof(Bucket) * (capacity + 1));
+            is.read(reinterpret_cast<char*>(loaded.occupied_),
+                    sizeof(std::uint64_t) * loaded.occupied_words());
+            if (!is || !loaded.raw_layout_valid(header)) {
+                // the flags need not even be valid bools, and T is trivial,
+                // so there is nothing to destroy
+                std::memset(static_cast<void*>(loaded.buckets_), 0,
+                            sizeof(Bucket) * (capacity + 1));
+                return false;
+            }
+            loaded.size_ = header.size;
+        } else {
+            std::vector<char> states(capacity);
+            is.read(states.data(), static_cast<std::streamsize>(capacity));
+
+            size_type deleted = 0;
+            for (size_type i = 0; i < capacity && is; ++i) {
+                // used, deleted, or neither
+                if (states[i] < 0 || states[i] > 2) return false;
+                auto& bucket = loaded.buckets_[i];
+                bucket.deleted = states[i] & 2;
+                deleted += bucket.deleted;
+                if (!(states[i] & 1)) continue;
+
+                T value;
+                Serializer::read(is, value);
+                if (!is) break;
+
+                new (bucket.slot()) T(std::move(value));
+                loaded.mark_used(bucket);
+                ++loaded.size_;
+            }
+            if (!is || loaded.size_ != header.size ||
+                deleted != header.deleted_count) {
+                return false;
+            }
+        }
+
+        loaded.deleted_count_ = header.deleted_count;
+        loaded.first_used_ = loaded.next_used_index(0);
+
+        if (header.load_factor_percent != load_factor_percent ||
+            header.fingerprint != loaded.hash_fingerprint()) {
+            loaded.rehash(loaded.capacity_);
+        }
+
+        swap(*this, loaded);
+        return true;
+    }
+
    private:
+    friend Iterator;
+    friend ConstIterator;
+
+    template <typename Serializer>
+    static constexpr bool is_raw_serializer() {
+        return std::is_same_v<Serializer, TrivialSerializer<T>>;
+    }
+
+    /* Whether a snapshot's counts could have come from save(): a table
+     * within its load factor, which leaves an empty bucket to end every
+     * probe. */
+    static bool counts_valid(const SnapshotHeader& header) {
+        if (header.capacity == 0) {
+            return header.size == 0 && header.deleted_count == 0;
+        }
+        constexpr std::uint64_t max_capacity =
+            std::numeric_limits<size_type>::max() / 100 / sizeof(Bucket);
+        auto buckets = header.size + header.deleted_count;
+        return header.capacity <= max_capacity &&
+               header.load_factor_percent > 0 &&
+               header.load_factor_percent <= 100 &&
+               header.size <= header.capacity &&
+               header.deleted_count <= header.capacity &&
+               buckets * 100 < header.capacity * header.load_factor_percent;
+    }
+
+    /* Whether a bucket array read verbatim by load() agrees with the
+     * snapshot's header: every flag is 0 or 1, only the sentinel is the
+     * end, the bitmap marks exactly the used buckets, and the counts add
+     * up. Flags are read as bytes, since corrupt ones need not be valid
+     * bools. */
+    bool raw_layout_valid(const SnapshotHeader& header) const {
+        auto flag = [](const bool& b) {
+            unsigned char byte;
+            std::memcpy(&byte, &b, 1);
+            return byte;
+        };
+
+        size_type used = 0, deleted = 0;
+        for (size_type i = 0; i <= capacity_; ++i) {
+            auto is_used = flag(buckets_[i].used);
+            auto is_deleted = flag(buckets_[i].deleted);
+            if (is_used > 1 || is_deleted > 1 || (is_used && is_deleted) ||
+                flag(buckets_[i].end) != (i == capacity_)) {
+                return false;
+            }
+            auto bit = occupied_[i / bits_per_word] >> (i % bits_per_word);
+            if ((bit & 1) != is_used) return false;
+            used += is_used;
+            deleted += is_deleted;
+        }
+
+        size_type bits = 0;
+        for (size_type w = 0; w < occupied_words(); ++w) {
+            bits += static_cast<size_type>(__builtin_popcountll(occupied_[w]));
+        }
+        return bits == used && used == header.size &&
+               deleted == header.deleted_count;
+    }
+
+    /* Summarizes the hash function the table was built with by hashing a
+     * sample of its entries. A snapshot whose fingerprint does not match
+     * the current hash function has its entries in the wrong buckets. */
+    std::uint32_t hash_fingerprint() const {
+        constexpr size_type sample_size = 16;
+
+        std::uint32_t fingerprint = 0;
+        auto index = first_used_;
+        for (size_type n = 0; n < sample_size && index < capacity_; ++n) {
+            fingerprint = fingerprint * 31 +
+                          hash_of(*buckets_[index].slot());
+            index = next_used_index(index + 1);
+        }
+
+        return fingerprint;
+    }
+
+    Iterator iterator_for(Bucket* bucket) { return Iterator(this, bucket); }
+    ConstIterator iterator_for(const Bucket* bucket) const {
+        return ConstIterator(this, bucket);
+    }
+
+    static constexpr size_type bits_per_word = 64;
+    size_type occupied_words() const {
+        return capacity_ / bits_per_word + 1;
+    }
+
+    void mark_used(Bucket& bucket) {
+        auto index = static_cast<size_type>(&bucket - buckets_);
+        occupied_[index / bits_per_word] |= std::uint64_t{1}
+                                            << (index % bits_per_word);
+        bucket.used = true;
+        first_used_ = std::min(first_used_, index);
+    }
+    void mark_unused(Bucket& bucket) {
+        auto index = static_cast<size_type>(&bucket - buckets_);
+        occupied_[index / bits_per_word] &=
+            ~(std::uint64_t{1} << (index % bits_per_word));
+        bucket.used = false;
+
+        // every bucket before the first used one is empty, so only the
+        // rest of the table has to be scanned for the new first one
+        if (index == first_used_) first_used_ = next_used_index(index + 1);
+    }
+
+    // index of the first used bucket at or after `from`, or capacity_
+    size_type next_used_index(size_type from) const {
+        return detail::next_set_bit(occupied_, capacity_, from);
+    }
+
+    Bucket* first_used_bucket() const {
+        return first_used_ < capacity_ ? &buckets_[first_used_] : nullptr;
+    }
+
     size_type used_buckets_count() const { return size_ + deleted_count_; }
     bool should_grow() const {
-        return ((used_buckets_count() + 1) * 100) >=
-               (capacity_ * load_factor_percent);
+        return detail::probing_should_grow(used_buckets_count(), capacity_);
     }
 
     void rehash(size_type new_capacity) {
@@ -281,93 +1029,219 @@ class HashTable {
 
         auto old_capacity = capacity_;
         auto* old_buckets = buckets_;
+        auto* old_occupied = occupied_;
 
-        auto* new_buckets =
-            (Bucket*)std::malloc(sizeof(Bucket) * (new_capacity + 1));
-        if (!new_buckets) {
-            return;
+        if (!allocate(new_capacity)) return;
+        deleted_count_ = 0;
+
+        if (!old_buckets) return;
+
+        if constexpr (batch_rehash) {
+            rehash_batched(old_buckets, old_capacity);
+        } else {
+            for (size_t i = 0; i < old_capacity; i++) {
+                // move from old table to new
+                auto& old_bucket = old_buckets[i];
+
+                // We insert only used objects, not deleted objects
+                if (old_bucket.used) {
+                    insert_during_rehash(*old_bucket.slot());
+                    old_bucket.slot()->~T();
+                }
+            }
         }
-        __builtin_memset(new_buckets, 0, sizeof(Bucket) * (new_capacity + 1));
+
+        std::free(old_buckets);
+        std::free(old_occupied);
+    }
+
+    /* Points the table at a fresh, empty bucket array of `capacity` buckets
+     * without touching the old one. Returns false if out of memory. The
+     * array starts on a cache line, so the probe kernels' group loads never
+     * straddle two. */
+    bool allocate(size_type capacity) {
+        constexpr size_type alignment =
+            std::max<size_type>(64, alignof(Bucket));
+        auto bytes = (sizeof(Bucket) * (capacity + 1) + alignment - 1) /
+                     alignment * alignment;
+        auto* new_buckets = (Bucket*)std::aligned_alloc(alignment, bytes);
+        auto* new_occupied = (std::uint64_t*)std::calloc(
+            capacity / bits_per_word + 1, sizeof(std::uint64_t));
+        if (!new_buckets || !new_occupied) {
+            std::free(new_buckets);
+            std::free(new_occupied);
+            return false;
+        }
+        __builtin_memset(new_buckets, 0, sizeof(Bucket) * (capacity + 1));
 
         buckets_ = new_buckets;
-        capacity_ = new_capacity;
-        deleted_count_ = 0;
+        occupied_ = new_occupied;
+        capacity_ = capacity;
+        first_used_ = capacity_;
 
         // sentinel pointer to mark end of line
         buckets_[capacity_].end = true;
+        return true;
+    }
 
-        if (!old_buckets) return;
+    /* Rehashing can hand the entries to hash_batch() only once they are
+     * side by side, so it copies them out of the old buckets a group at a
+     * time; that takes trivially copyable entries. */
+    static constexpr bool batch_rehash =
+        !seeded && detail::has_hash_batch_v<TraitsForT, T> &&
+        std::is_trivially_copyable_v<T>;
+
+    void rehash_batched(Bucket* old_buckets, size_type old_capacity) {
+        alignas(T) unsigned char group[sizeof(T) * batch_size];
+        auto* values = reinterpret_cast<T*>(group);
+        unsigned hashes[batch_size];
+        size_type count = 0;
+
+        auto insert_group = [&] {
+            TraitsForT::hash_batch(values, count, hashes);
+            for (size_type i = 0; i < count; ++i) {
+                insert_during_rehash(hashes[i], values[i]);
+            }
+            count = 0;
+        };
 
-        for (size_t i = 0; i < old_capacity; i++) {
-            // move from old table to new
-            auto& old_bucket = old_buckets[i];
+        for (size_type i = 0; i < old_capacity; ++i) {
+            if (!old_buckets[i].used) continue;
 
-            // We insert only used objects, not deleted objects
-            if (old_bucket.used) {
-                insert_during_rehash(*old_bucket.slot());
-                old_bucket.slot()->~T();
-            }
+            std::memcpy(&values[count], old_buckets[i].slot(), sizeof(T));
+            if (++count == batch_size) insert_group();
         }
-
-        std::free(old_buckets);
+        if (count) insert_group();
     }
 
     void insert_during_rehash(T& val) {
-        auto& bucket = lookup_for_writing(val);
+        insert_during_rehash(hash_of(val), val);
+    }
+    void insert_during_rehash(unsigned hash, T& val) {
+        size_type probes;
+        auto& bucket = probe_for_writing(hash, val, probes);
 
         /* We use the placement new syntax. This allows us to
          * provide the address where the object should be constructed.*/
         new (bucket.slot()) T(val);
-        bucket.used = true;
+        mark_used(bucket);
     }
 
     template <typename Pred>
     Bucket* lookup_with_hash(unsigned hash, Pred predicate) const {
         if (empty()) return nullptr;
 
-        auto index = hash % capacity_;
-        for (;;) {
-            auto& bucket = buckets_[index];
-
-            if (bucket.used && predicate(*bucket.slot())) return &bucket;
-
-            if (!bucket.used && !bucket.deleted) return nullptr;
+        auto index = detail::probe_find(
+            buckets_, capacity_, hash % capacity_,
+            [&](const Bucket& bucket) { return predicate(*bucket.slot()); });
+        return index < capacity_ ? &buckets_[index] : nullptr;
+    }
 
-            // Linear probing
-            index = (index + 1) % capacity_;
+    /* Integer keys compared with plain ==, in buckets of one or two 64-bit
+     * words, are looked up with the SIMD kernels in detail::probe_avx2()
+     * and probe_avx512() on CPUs that have them: those test a whole group
+     * of buckets' flags and keys at once instead of one bucket per step. */
+    static constexpr bool simd_probe =
+        std::is_integral_v<T> && detail::has_bitwise_equals_v<TraitsForT> &&
+        (sizeof(Bucket) == 8 || sizeof(Bucket) == 16);
+    static constexpr size_type probe_words = sizeof(Bucket) / 8;
+
+    // the bucket holding `value`, or nullptr; `hash` must be hash_of(value)
+    Bucket* lookup_for_reading(unsigned hash, const T& value) const {
+        if constexpr (simd_probe) {
+            if (auto kernel = detail::probe_kernel<probe_words>()) {
+                if (empty()) return nullptr;
+
+                // Most probes end at the home bucket, and testing that one
+                // needs neither the call nor a second cache line.
+                auto index = hash % capacity_;
+                auto& home = buckets_[index];
+                if (home.used && *home.slot() == value) return &home;
+                if (!home.used && !home.deleted) return nullptr;
+
+                index = index + 1 == capacity_ ? 0 : index + 1;
+                index = kernel(reinterpret_cast<const unsigned char*>(buckets_),
+                               capacity_, index, probe_words_for(value));
+                return index < capacity_ ? &buckets_[index] : nullptr;
+            }
         }
-    }
-    const Bucket* lookup_for_reading(const T& value) const {
-        lookup_with_hash(TraitsForT::hash(value), [&value](auto& entry) {
+        return lookup_with_hash(hash, [&value](auto& entry) {
             return TraitsForT::equals(entry, value);
         });
     }
 
-    Bucket& lookup_for_writing(const T& value) {
+    // What lookup_for_reading() looks for, read off the Bucket layout.
+    static detail::ProbeWords probe_words_for(const T& value) {
+        constexpr auto used = offsetof(Bucket, used);
+        constexpr auto deleted = offsetof(Bucket, deleted);
+        constexpr auto storage = offsetof(Bucket, storage);
+
+        unsigned char match_mask[16] = {}, match_bits[16] = {};
+        unsigned char empty_mask[16] = {};
+        match_mask[used] = 0xff;
+        match_bits[used] = 1;
+        std::memset(match_mask + storage, 0xff, sizeof(T));
+        std::memcpy(match_bits + storage, &value, sizeof(T));
+        empty_mask[used] = empty_mask[deleted] = 0xff;
+
+        detail::ProbeWords p{};
+        std::memcpy(p.match_mask, match_mask, sizeof(match_mask));
+        std::memcpy(p.match_bits, match_bits, sizeof(match_bits));
+        std::memcpy(p.empty_mask, empty_mask, sizeof(empty_mask));
+        return p;
+    }
+
+    /* Returns the bucket `value` is stored in, or the one to store it in.
+     * In a seeded table, a probe longer than linear probing at our load
+     * factor plausibly ever needs means the keys were picked to collide;
+     * the table then reseeds, and `hash` is recomputed with the new seed.
+     * Some collisions survive any seed, like those of a hash that ignores
+     * it, so the table reseeds at most once per capacity and otherwise
+     * takes the long probe: a flood of such keys costs what it would
+     * without seeding, not a rehash per insert. */
+    Bucket& lookup_for_writing(unsigned hash, const T& value) {
         if (should_grow()) {
             rehash(capacity() * 2);
         }
 
-        auto hash = TraitsForT::hash(value);
-        auto bucket_index = hash % capacity_;
-
-        /*We need to return the first empty bucket we come across or the bucket
-        which needs to be replaced*/
-        Bucket* first_empty_bucket = nullptr;
-        while (true) {
-            auto& bucket = buckets_[bucket_index];
-
-            if (bucket.used && TraitsForT::equals(*bucket.slot(), value))
-                return bucket;
+        size_type probes;
+        auto& bucket = probe_for_writing(hash, value, probes);
+        if constexpr (seeded) {
+            if (probes > reseed_probe_length() &&
+                reseeded_at_ != capacity_) {
+                reseed();
+                return probe_for_writing(hash_of(value), value, probes);
+            }
+        }
+        return bucket;
+    }
 
-            if (!bucket.used) {
-                if (!first_empty_bucket) first_empty_bucket = &bucket;
+    // the first empty bucket on the probe, or the one holding `value`
+    Bucket& probe_for_writing(unsigned hash, const T& value,
+                              size_type& probes) {
+        return buckets_[detail::probe_for_insert(
+            buckets_, capacity_, hash % capacity_,
+            [&value](const Bucket& bucket) {
+                return TraitsForT::equals(*bucket.slot(), value);
+            },
+            probes)];
+    }
 
-                if (!bucket.deleted) return *first_empty_bucket;
-            }
+    /* The longest run linear probing builds at 60% load grows like
+     * 9 ln(capacity), about 60 buckets at a thousand and 130 at a million;
+     * this stays well clear of it, so honest keys practically never
+     * trigger a reseed. */
+    size_type reseed_probe_length() const {
+        auto log2_capacity =
+            static_cast<size_type>(63 - __builtin_clzll(capacity_));
+        return 64 + 8 * log2_capacity;
+    }
 
-            bucket_index = (bucket_index + 1) % capacity_;
-        }
+    // Moves every entry to where a new seed hashes it.
+    void reseed() {
+        seed_ = detail::new_table_seed();
+        rehash(capacity_);
+        reseeded_at_ = capacity_;
     }
 };
 }  // namespace hashfu
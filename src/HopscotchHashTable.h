@@ -0,0 +1,237 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <type_traits>
+#include <utility>
+
+#include "DisplacingTable.h"
+
+namespace hashfu {
+
+namespace detail {
+template <typename T, std::size_t H>
+struct HopscotchBucket {
+    using Bitmap = std::conditional_t<H == 32, std::uint32_t, std::uint64_t>;
+
+    // bit i is set while the bucket i places on holds an entry whose home
+    // is this bucket
+    Bitmap neighbors;
+    bool used;
+    alignas(T) unsigned char storage[sizeof(T)];
+
+    T* slot() { return reinterpret_cast<T*>(storage); }
+    const T* slot() const { return reinterpret_cast<const T*>(storage); }
+};
+}  // namespace detail
+
+/* HashTable alternative that keeps lookups short at 80-90% occupancy,
+ * where linear probing's clusters run long. Every entry is stored within
+ * H buckets of its home bucket, and each home bucket has a bitmap of
+ * which of those H buckets hold its entries, so a lookup only visits
+ * buckets that hold an entry with the same home. An insert takes the
+ * first free bucket after the home bucket and, while that is too far
+ * away, swaps it with an entry closer to the home that can move there
+ * without leaving its own neighborhood.
+ *
+ * H = 32 fills to 80%, H = 64 to 90% at the cost of larger buckets.
+ *
+ * The public API is HashTable's, without snapshots, and HashMap takes it
+ * as its table through HopscotchTable below:
+ *     HashMap<K, V, KeyTraits, HopscotchTable> map;
+ * Inserts may move entries, so they invalidate iterators and references.
+ * Entries that fit nowhere in a table less than half full, which takes
+ * many keys with the same hash, go to a small overflow list that lookups
+ * scan as well.
+ */
+template <typename T, typename TraitsForT = DefaultTraits<T>,
+          std::size_t H = 32>
+class HopscotchHashTable
+    : public detail::DisplacingTable<HopscotchHashTable<T, TraitsForT, H>, T,
+                                     TraitsForT,
+                                     detail::HopscotchBucket<T, H>> {
+    static_assert(H == 32 || H == 64, "neighborhoods are 32 or 64 buckets");
+
+    using Bucket = detail::HopscotchBucket<T, H>;
+    using Bitmap = typename Bucket::Bitmap;
+    using Base =
+        detail::DisplacingTable<HopscotchHashTable, T, TraitsForT, Bucket>;
+    friend Base;
+
+    /* bucket_count_ is a power of two: home buckets are picked by the
+     * hash's low bits. The array has H - 1 more buckets past those, so
+     * that the neighborhoods at the end don't wrap around. */
+    using Base::bucket_count_;
+    using Base::buckets_;
+
+   public:
+    using typename Base::size_type;
+    using typename Base::value_type;
+
+    static constexpr size_type slots_per_bucket = 1;
+    /* the table grows before more than this share of buckets is in use;
+     * past it, runs of more than H keys for H buckets get likely enough
+     * in large tables that inserts start failing */
+    static constexpr size_t load_factor_percent = H == 32 ? 80 : 90;
+
+    HopscotchHashTable() = default;
+    explicit HopscotchHashTable(size_type capacity) {
+        this->reserve(capacity);
+    }
+
+    template <typename InputIt>
+    HopscotchHashTable(InputIt first, InputIt last,
+                       size_type bucket_count = 4) {
+        this->reserve(bucket_count);
+
+        while (first != last) {
+            this->insert(*first);
+            ++first;
+        }
+    }
+
+    HopscotchHashTable(std::initializer_list<value_type> list)
+        : HopscotchHashTable(list.begin(), list.end(), list.size()) {}
+
+    ~HopscotchHashTable() { this->destroy(); }
+
+    HopscotchHashTable(const HopscotchHashTable& other) : Base() {
+        this->reserve(other.size());
+
+        for (const auto& i : other) {
+            this->insert(i);
+        }
+    }
+    HopscotchHashTable& operator=(const HopscotchHashTable&) = default;
+    HopscotchHashTable(HopscotchHashTable&&) noexcept = default;
+    HopscotchHashTable& operator=(HopscotchHashTable&&) noexcept = default;
+
+    HopscotchHashTable& operator=(std::initializer_list<value_type> list) {
+        HopscotchHashTable temp(list);
+        this->swap(*this, temp);
+        return *this;
+    }
+
+    // Pulls the home bucket of `hash` into cache ahead of a lookup.
+    void prefetch(unsigned hash) const {
+        if (!buckets_) return;
+        __builtin_prefetch(&buckets_[home_bucket(hash)]);
+    }
+
+   private:
+    static constexpr size_type min_buckets = 8;
+    // how far an insert looks for a free bucket before giving up on it
+    static constexpr size_type max_distance = 16 * H;
+
+    size_type total_buckets() const { return bucket_count_ + H - 1; }
+    // positions are bucket indices
+    size_type table_end() const { return total_buckets(); }
+    T* slot_at(size_type position) { return buckets_[position].slot(); }
+
+    size_type home_bucket(unsigned hash) const {
+        return hash & (bucket_count_ - 1);
+    }
+
+    size_type next_used_in_table(size_type from) const {
+        for (; from < total_buckets(); ++from) {
+            if (buckets_[from].used) return from;
+        }
+        return total_buckets();
+    }
+
+    template <typename Pred>
+    size_type lookup_in_table(unsigned hash, Pred predicate) const {
+        auto home = home_bucket(hash);
+        for (Bitmap bits = buckets_[home].neighbors; bits; bits &= bits - 1) {
+            auto index = home + static_cast<size_type>(__builtin_ctzll(bits));
+            if (predicate(*buckets_[index].slot())) return index;
+        }
+        return total_buckets();
+    }
+
+    void remove_from_table(size_type position) {
+        auto& bucket = buckets_[position];
+        assert(bucket.used);
+        bucket.slot()->~T();
+        bucket.used = false;
+
+        // the one home whose bitmap has this bucket
+        for (size_type d = 0; d < H && d <= position; ++d) {
+            auto bit = Bitmap{1} << d;
+            if (buckets_[position - d].neighbors & bit) {
+                buckets_[position - d].neighbors ^= bit;
+                break;
+            }
+        }
+    }
+
+    /* Copies `value` into a free bucket of its neighborhood, first moving
+     * the nearest free bucket after its home back into the neighborhood if
+     * need be. Returns false if that can't be done. */
+    bool place(unsigned hash, const T& value) {
+        auto home = home_bucket(hash);
+        auto last = std::min(total_buckets(), home + max_distance);
+
+        auto free = home;
+        while (free < last && buckets_[free].used) ++free;
+        if (free == last) return false;
+
+        while (free - home >= H) {
+            if (!hop_back(free)) return false;
+        }
+
+        new (buckets_[free].slot()) T(value);
+        buckets_[free].used = true;
+        buckets_[home].neighbors |= Bitmap{1} << (free - home);
+        return true;
+    }
+
+    /* Moves into bucket `free` the entry furthest from it, among those
+     * before it whose neighborhood also covers it, and points `free` at
+     * the bucket that entry left. Returns false if there is no such
+     * entry. */
+    bool hop_back(size_type& free) {
+        for (auto home = free - (H - 1); home < free; ++home) {
+            // neighbors of `home` that sit before `free`
+            auto before = buckets_[home].neighbors &
+                          ((Bitmap{1} << (free - home)) - 1);
+            if (!before) continue;
+
+            auto from = home + static_cast<size_type>(__builtin_ctzll(before));
+            new (buckets_[free].slot()) T(std::move(*buckets_[from].slot()));
+            buckets_[from].slot()->~T();
+            buckets_[free].used = true;
+            buckets_[from].used = false;
+            buckets_[home].neighbors ^=
+                (Bitmap{1} << (from - home)) | (Bitmap{1} << (free - home));
+
+            free = from;
+            return true;
+        }
+        return false;
+    }
+
+    // Points an empty table at a fresh bucket array.
+    bool allocate(size_type bucket_count) {
+        assert(!buckets_ && bucket_count >= min_buckets);
+        auto total = bucket_count + H - 1;
+        buckets_ = Base::allocate_buckets(total);
+        if (!buckets_) return false;
+
+        for (size_type i = 0; i < total; ++i) {
+            buckets_[i].neighbors = 0;
+            buckets_[i].used = false;
+        }
+        bucket_count_ = bucket_count;
+        return true;
+    }
+};
+
+/* HopscotchHashTable with the default neighborhood, for HashMap's Table,
+ * which takes a template of the entry type and its traits only. */
+template <typename T, typename TraitsForT = DefaultTraits<T>>
+using HopscotchTable = HopscotchHashTable<T, TraitsForT>;
+}  // namespace hashfu
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "Arena.h"
+#include "HashTable.h"
+
+namespace hashfu {
+
+/* Maps strings to small integer ids and back. Every distinct string is
+ * stored once, in an arena, and gets the next id starting from 0; interning
+ * it again returns the same id, so code holding ids can compare strings
+ * with a single integer compare. Views returned by lookup() stay valid for
+ * the lifetime of the interner.
+ *
+ * KeyTraits works on std::string_view. Seeded KeyTraits get a random seed
+ * per interner, as in HashTable, though the interner never reseeds. Not
+ * thread-safe; see ShardedInterner.
+ */
+template <typename KeyTraits = DefaultTraits<std::string_view>>
+class Interner {
+   public:
+    using Id = std::uint32_t;
+
+   private:
+    struct Slot {
+        Id id;
+        // cached so that rehashing never has to touch the strings
+        std::uint32_t hash;
+    };
+    struct SlotTraits {
+        static unsigned hash(const Slot& s) { return s.hash; }
+        // Inserts only happen after a lookup by content came up empty, so a
+        // new slot only has to be told apart from the ones already stored.
+        static bool equals(const Slot& a, const Slot& b) {
+            return a.id == b.id;
+        }
+    };
+
+    HashTable<Slot, SlotTraits> table_;
+    std::vector<std::string_view> strings_;
+    Arena arena_;
+    std::uint64_t seed_{
+        detail::has_seeded_hash_v<KeyTraits, std::string_view>
+            ? detail::new_table_seed()
+            : 0};
+
+   public:
+    Interner() = default;
+    // An interner hashing with `seed`, for interners that share hashes.
+    explicit Interner(std::uint64_t seed) : seed_(seed) {}
+
+    Interner(const Interner&) = delete;
+    Interner& operator=(const Interner&) = delete;
+    Interner(Interner&&) noexcept = default;
+    Interner& operator=(Interner&&) noexcept = default;
+
+    [[nodiscard]] bool empty() const { return strings_.empty(); }
+    // number of distinct strings, and so one past the largest id
+    std::size_t size() const { return strings_.size(); }
+
+    /* Hash of `str` in this interner: KeyTraits::hash(str), or, for traits
+     * that take a seed, KeyTraits::hash(str, seed()). */
+    unsigned hash_of(std::string_view str) const {
+        return detail::hash_with<KeyTraits>(str, seed_);
+    }
+    std::uint64_t seed() const { return seed_; }
+
+    Id intern(std::string_view str) {
+        return intern_with_hash(str, hash_of(str));
+    }
+    // `hash` must be hash_of(str)
+    Id intern_with_hash(std::string_view str, unsigned hash) {
+        if (auto id = find_with_hash(str, hash)) return *id;
+
+        assert(strings_.size() < std::numeric_limits<Id>::max());
+        auto id = static_cast<Id>(strings_.size());
+        strings_.push_back(arena_.copy(str));
+        table_.insert_with_hash(hash, {id, hash});
+        return id;
+    }
+
+    // Id of `str` if it has been interned, without interning it.
+    std::optional<Id> find(std::string_view str) const {
+        return find_with_hash(str, hash_of(str));
+    }
+    std::optional<Id> find_with_hash(std::string_view str,
+                                     unsigned hash) const {
+        auto it = table_.find(hash, [&](const Slot& s) {
+            return s.hash == hash && KeyTraits::equals(strings_[s.id], str);
+        });
+        if (it == table_.end()) return std::nullopt;
+        return it->id;
+    }
+
+    // `id` must have been returned by intern()
+    std::string_view lookup(Id id) const {
+        assert(id < strings_.size());
+        return strings_[id];
+    }
+};
+
+/* Thread-safe Interner split into Shards independently locked shards,
+ * picked by the string's hash so that threads interning different strings
+ * rarely wait for each other. Ids interleave across shards: shard s hands
+ * out s, s + Shards, s + 2 * Shards, ... so they are unique but not dense.
+ */
+template <typename KeyTraits = DefaultTraits<std::string_view>,
+          std::size_t Shards = 16>
+class ShardedInterner {
+    static_assert(Shards > 0 && (Shards & (Shards - 1)) == 0,
+                  "the shard count must be a power of two");
+
+   public:
+    using Id = typename Interner<KeyTraits>::Id;
+
+   private:
+    // one cache line per shard, so neighbouring locks don't contend
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        Interner<KeyTraits> interner;
+    };
+
+    Shard shards_[Shards];
+
+   public:
+    // every shard hashes with the first one's seed, which picks shards too
+    ShardedInterner() {
+        for (auto& shard : shards_) {
+            shard.interner = Interner<KeyTraits>(shards_[0].interner.seed());
+        }
+    }
+
+    ShardedInterner(const ShardedInterner&) = delete;
+    ShardedInterner& operator=(const ShardedInterner&) = delete;
+
+    std::size_t size() const {
+        std::size_t total = 0;
+        for (const auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            total += shard.interner.size();
+        }
+        return total;
+    }
+
+    Id intern(std::string_view str) {
+        auto hash = shards_[0].interner.hash_of(str);
+        auto index = shard_index(hash);
+        auto& shard = shards_[index];
+
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return to_global(shard.interner.intern_with_hash(str, hash), index);
+    }
+
+    std::optional<Id> find(std::string_view str) const {
+        auto hash = shards_[0].interner.hash_of(str);
+        auto index = shard_index(hash);
+        const auto& shard = shards_[index];
+
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto id = shard.interner.find_with_hash(str, hash);
+        if (!id) return std::nullopt;
+        return to_global(*id, index);
+    }
+
+    // `id` must have been returned by intern()
+    std::string_view lookup(Id id) const {
+        const auto& shard = shards_[id % Shards];
+
+        // the view points into the arena and stays valid once unlocked
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return shard.interner.lookup(static_cast<Id>(id / Shards));
+    }
+
+   private:
+    // skips the lowest bits, which also pick the bucket inside the shard
+    static std::size_t shard_index(unsigned hash) {
+        return (hash >> 16) & (Shards - 1);
+    }
+    // Each shard has room for 1 / Shards of the id space.
+    static Id to_global(Id local, std::size_t index) {
+        assert(local <= (std::numeric_limits<Id>::max() - index) / Shards);
+        return static_cast<Id>(local * Shards + index);
+    }
+};
+}  // namespace hashfu
@@ -0,0 +1,251 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "HashTable.h"
+
+namespace hashfu {
+
+/* Hands out fixed-size nodes carved from slabs of slab_size, recycling
+ * freed ones through a free list. Nodes never move once created. */
+template <typename T>
+class NodePool {
+    static constexpr std::size_t slab_size = 64;
+
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    std::vector<Slot*> slabs_;
+    Slot* free_{nullptr};
+
+   public:
+    NodePool() = default;
+    ~NodePool() {
+        for (auto* slab : slabs_) ::operator delete(slab);
+    }
+
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    NodePool(NodePool&& other) noexcept { swap(*this, other); }
+    NodePool& operator=(NodePool&& other) noexcept {
+        swap(*this, other);
+        return *this;
+    }
+
+    friend void swap(NodePool& a, NodePool& b) noexcept {
+        std::swap(a.slabs_, b.slabs_);
+        std::swap(a.free_, b.free_);
+    }
+
+    template <typename... Args>
+    T* create(Args&&... args) {
+        if (!free_) grow();
+
+        auto* slot = free_;
+        free_ = slot->next;
+        return new (slot->storage) T{std::forward<Args>(args)...};
+    }
+
+    void destroy(T* node) {
+        node->~T();
+        auto* slot = reinterpret_cast<Slot*>(node);
+        slot->next = free_;
+        free_ = slot;
+    }
+
+   private:
+    void grow() {
+        auto* slab =
+            static_cast<Slot*>(::operator new(sizeof(Slot) * slab_size));
+        slabs_.push_back(slab);
+
+        for (std::size_t i = 0; i < slab_size; ++i) {
+            slab[i].next = free_;
+            free_ = &slab[i];
+        }
+    }
+};
+
+template <typename TableIterator, typename Node>
+class NodeHashMapIterator {
+    template <typename, typename, typename>
+    friend class NodeHashMap;
+
+    TableIterator it_;
+
+    explicit NodeHashMapIterator(TableIterator it) : it_(it) {}
+
+   public:
+    NodeHashMapIterator() = default;
+
+    friend bool operator==(const NodeHashMapIterator& lhs,
+                           const NodeHashMapIterator& rhs) {
+        return lhs.it_ == rhs.it_;
+    }
+    friend bool operator!=(const NodeHashMapIterator& lhs,
+                           const NodeHashMapIterator& rhs) {
+        return lhs.it_ != rhs.it_;
+    }
+
+    Node& operator*() { return *it_->node; }
+    Node* operator->() { return it_->node; }
+
+    void operator++() { ++it_; }
+};
+
+/* HashMap variant that keeps every entry in its own pool-allocated node,
+ * while the open addressing table only holds a pointer to the node and its
+ * hash. Growing the table moves those small handles instead of the entries,
+ * and references to keys and values stay valid until the entry is removed.
+ * Worth it for large V; for small ones the extra indirection costs more.
+ *
+ * Seeded KeyTraits get a random seed per map, as in HashTable, but since
+ * the handles cache the hashes the map never reseeds.
+ */
+template <typename K, typename V, typename KeyTraits = DefaultTraits<K>>
+class NodeHashMap {
+   public:
+    struct Node {
+        K key;
+        V value;
+    };
+
+   private:
+    struct Handle {
+        Node* node;
+        // cached so that rehashing never has to touch the node
+        unsigned hash;
+    };
+    struct HandleTraits {
+        static unsigned hash(const Handle& h) { return h.hash; }
+        // Inserts only happen after a lookup by key came up empty, so a new
+        // handle only has to be told apart from the ones already stored.
+        static bool equals(const Handle& a, const Handle& b) {
+            return a.node == b.node;
+        }
+    };
+    using HashTableType = HashTable<Handle, HandleTraits>;
+
+    // whether KeyTraits::hash takes the map's seed
+    static constexpr bool seeded = detail::has_seeded_hash_v<KeyTraits, K>;
+
+    HashTableType table_;
+    NodePool<Node> pool_;
+    std::uint64_t seed_{seeded ? detail::new_table_seed() : 0};
+
+   public:
+    using Iterator =
+        NodeHashMapIterator<typename HashTableType::Iterator, Node>;
+    using ConstIterator =
+        NodeHashMapIterator<typename HashTableType::ConstIterator, const Node>;
+
+    NodeHashMap() = default;
+    ~NodeHashMap() { destroy_nodes(); }
+
+    NodeHashMap(const NodeHashMap& other) {
+        reserve(other.size());
+        for (const auto& node : other) insert(node.key, node.value);
+    }
+    NodeHashMap& operator=(const NodeHashMap& other) {
+        if (this != &other) {
+            NodeHashMap temp(other);
+            swap(*this, temp);
+        }
+        return *this;
+    }
+
+    NodeHashMap(NodeHashMap&& other) noexcept { swap(*this, other); }
+    NodeHashMap& operator=(NodeHashMap&& other) noexcept {
+        swap(*this, other);
+        return *this;
+    }
+
+    friend void swap(NodeHashMap& a, NodeHashMap& b) noexcept {
+        a.table_.swap(a.table_, b.table_);
+        swap(a.pool_, b.pool_);
+        std::swap(a.seed_, b.seed_);
+    }
+
+    [[nodiscard]] bool empty() const { return table_.empty(); }
+    size_t size() const { return table_.size(); }
+    size_t capacity() const { return table_.capacity(); }
+    float load_factor() const { return table_.load_factor(); }
+
+    void clear() { *this = NodeHashMap(); }
+    void reserve(size_t count) { table_.reserve(count); }
+
+    Iterator begin() noexcept { return Iterator(table_.begin()); }
+    Iterator end() noexcept { return Iterator(table_.end()); }
+    ConstIterator begin() const noexcept {
+        return ConstIterator(table_.begin());
+    }
+    ConstIterator end() const noexcept { return ConstIterator(table_.end()); }
+    ConstIterator cbegin() const noexcept { return begin(); }
+    ConstIterator cend() const noexcept { return end(); }
+
+    Iterator find(const K& key) { return Iterator(find_handle(key)); }
+    ConstIterator find(const K& key) const {
+        return ConstIterator(find_handle(key));
+    }
+
+    bool contains(const K& key) const { return find(key) != end(); }
+
+    HashTableResult insert(const K& key, const V& value) {
+        auto hash = hash_of(key);
+        auto it = find_handle(key, hash);
+        if (it != table_.end()) {
+            it->node->value = value;
+            return HashTableResult::ReplacedExistingEntry;
+        }
+
+        return table_.insert_with_hash(hash, {pool_.create(key, value), hash});
+    }
+
+    bool remove(const K& key) {
+        auto it = find_handle(key);
+        if (it == table_.end()) return false;
+
+        auto* node = it->node;
+        table_.remove(it);
+        pool_.destroy(node);
+        return true;
+    }
+
+    V& operator[](const K& key) {
+        auto it = find(key);
+        if (it == end()) insert(key, V());
+        return find(key)->value;
+    }
+
+   private:
+    unsigned hash_of(const K& key) const {
+        return detail::hash_with<KeyTraits>(key, seed_);
+    }
+
+    typename HashTableType::Iterator find_handle(const K& key) {
+        return find_handle(key, hash_of(key));
+    }
+    typename HashTableType::Iterator find_handle(const K& key, unsigned hash) {
+        return table_.find(hash, [&](const Handle& h) {
+            return h.hash == hash && KeyTraits::equals(key, h.node->key);
+        });
+    }
+    typename HashTableType::ConstIterator find_handle(const K& key) const {
+        auto hash = hash_of(key);
+        return table_.find(hash, [&](const Handle& h) {
+            return h.hash == hash && KeyTraits::equals(key, h.node->key);
+        });
+    }
+
+    void destroy_nodes() {
+        for (auto& handle : table_) pool_.destroy(handle.node);
+    }
+};
+}  // namespace hashfu
@@ -0,0 +1,276 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "HashMap.h"
+
+namespace hashfu {
+
+/* Minimal perfect hash over a fixed set of keys, built PTHash style: keys
+ * are split into small buckets, and for every bucket, largest first, a
+ * "pilot" value is searched for that sends all of its keys to free
+ * positions. Lookups then cost one hash, one pilot load and a couple of
+ * multiplies.
+ *
+ * Positions are computed from KeyTraits::hash, so keys sharing a 32-bit
+ * hash share a position too; size() counts distinct hashes, and callers
+ * that need to tell such keys apart (like PerfectHashMap) have to verify
+ * with KeyTraits::equals anyway. Keys that are not in the set map to some
+ * arbitrary position.
+ */
+template <typename K, typename KeyTraits = DefaultTraits<K>>
+class MinimalPerfectHash {
+    // average keys per bucket
+    static constexpr std::size_t bucket_load = 4;
+    // positions are picked out of size() / 0.98 slots and the ones past
+    // size() are remapped onto the holes below it afterwards
+    static constexpr std::size_t slack_percent = 2;
+    static constexpr std::uint32_t max_pilot = 1u << 16;
+    static constexpr std::uint32_t max_attempts = 8;
+
+    std::size_t size_{0};
+    std::size_t table_size_{0};
+    std::uint32_t seed_{0};
+    std::vector<std::uint32_t> pilots_;
+    std::vector<std::uint32_t> remap_;
+
+   public:
+    MinimalPerfectHash() = default;
+
+    // Returns false if no perfect hash could be found for the keys.
+    template <typename InputIt>
+    bool build(InputIt first, InputIt last) {
+        std::vector<unsigned> hashes;
+        for (; first != last; ++first) {
+            hashes.push_back(KeyTraits::hash(*first));
+        }
+        return build_from_hashes(std::move(hashes));
+    }
+
+    bool build_from_hashes(std::vector<unsigned> hashes) {
+        std::sort(hashes.begin(), hashes.end());
+        hashes.erase(std::unique(hashes.begin(), hashes.end()), hashes.end());
+
+        for (std::uint32_t attempt = 0; attempt < max_attempts; ++attempt) {
+            seed_ = attempt;
+            if (try_build(hashes)) return true;
+        }
+
+        *this = MinimalPerfectHash();
+        return false;
+    }
+
+    [[nodiscard]] bool empty() const { return size_ == 0; }
+    // number of distinct hashes, and so of positions
+    std::size_t size() const { return size_; }
+
+    // Position of `key` in [0, size()); must not be called when empty().
+    std::size_t index(const K& key) const {
+        return index_for_hash(KeyTraits::hash(key));
+    }
+    std::size_t index_for_hash(unsigned hash) const {
+        auto x = key_mix(hash);
+        auto pos = position(x, pilots_[bucket_of(x)]);
+        return pos < size_ ? pos : remap_[pos - size_];
+    }
+
+   private:
+    static std::uint64_t mix(std::uint64_t x) {
+        // splitmix64 finalizer
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ull;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebull;
+        x ^= x >> 31;
+        return x;
+    }
+    std::uint64_t key_mix(unsigned hash) const {
+        return mix((std::uint64_t{seed_} << 32) | hash);
+    }
+    // maps a 32-bit value onto [0, n) with a multiply instead of a modulo
+    static std::size_t reduce(std::uint64_t value, std::size_t n) {
+        return static_cast<std::size_t>(((value & 0xffffffffu) * n) >> 32);
+    }
+    std::size_t bucket_of(std::uint64_t x) const {
+        return reduce(x >> 32, pilots_.size());
+    }
+    std::size_t position(std::uint64_t x, std::uint32_t pilot) const {
+        return reduce(x ^ mix(pilot), table_size_);
+    }
+
+    bool try_build(const std::vector<unsigned>& hashes) {
+        size_ = hashes.size();
+        table_size_ = size_ + size_ * slack_percent / 100 + 1;
+        auto num_buckets = size_ / bucket_load + 1;
+        pilots_.assign(num_buckets, 0);
+
+        // group the mixed hashes by bucket
+        std::vector<std::size_t> bucket_start(num_buckets + 1, 0);
+        for (auto hash : hashes) ++bucket_start[bucket_of(key_mix(hash)) + 1];
+        for (std::size_t b = 0; b < num_buckets; ++b) {
+            bucket_start[b + 1] += bucket_start[b];
+        }
+
+        std::vector<std::uint64_t> mixed(size_);
+        auto fill = bucket_start;
+        for (auto hash : hashes) {
+            auto x = key_mix(hash);
+            mixed[fill[bucket_of(x)]++] = x;
+        }
+
+        // place the biggest buckets first, while most positions are free
+        std::vector<std::size_t> order(num_buckets);
+        for (std::size_t b = 0; b < num_buckets; ++b) order[b] = b;
+        std::stable_sort(order.begin(), order.end(), [&](auto a, auto b) {
+            return bucket_start[a + 1] - bucket_start[a] >
+                   bucket_start[b + 1] - bucket_start[b];
+        });
+
+        std::vector<bool> taken(table_size_, false);
+        std::vector<std::size_t> positions;
+
+        for (auto b : order) {
+            auto begin = bucket_start[b];
+            auto end = bucket_start[b + 1];
+            if (begin == end) break;
+
+            std::uint32_t pilot = 0;
+            for (; pilot < max_pilot; ++pilot) {
+                if (fits(mixed, begin, end, pilot, taken, positions)) break;
+            }
+            if (pilot == max_pilot) return false;
+
+            pilots_[b] = pilot;
+            for (auto pos : positions) taken[pos] = true;
+        }
+
+        // the positions past size() take over the free ones below it
+        remap_.assign(table_size_ - size_, 0);
+        std::size_t hole = 0;
+        for (auto pos = size_; pos < table_size_; ++pos) {
+            if (!taken[pos]) continue;
+
+            while (taken[hole]) ++hole;
+            remap_[pos - size_] = static_cast<std::uint32_t>(hole++);
+        }
+
+        return true;
+    }
+
+    // Whether `pilot` sends the keys mixed[begin, end) to distinct free
+    // positions, which are left in `positions`.
+    bool fits(const std::vector<std::uint64_t>& mixed, std::size_t begin,
+              std::size_t end, std::uint32_t pilot,
+              const std::vector<bool>& taken,
+              std::vector<std::size_t>& positions) const {
+        positions.clear();
+        for (auto i = begin; i < end; ++i) {
+            auto pos = position(mixed[i], pilot);
+            if (taken[pos] || std::find(positions.begin(), positions.end(),
+                                        pos) != positions.end()) {
+                return false;
+            }
+            positions.push_back(pos);
+        }
+        return true;
+    }
+};
+
+/* Immutable map built from a HashMap on top of MinimalPerfectHash: entries
+ * are stored densely in position order, so a lookup is a single probe with
+ * no empty slots to skip. The rare keys whose 32-bit hash collides with
+ * another key's are kept in a small overflow array sorted by hash.
+ */
+template <typename K, typename V, typename KeyTraits = DefaultTraits<K>>
+class PerfectHashMap {
+   public:
+    struct Entry {
+        K key;
+        V value;
+    };
+
+   private:
+    MinimalPerfectHash<K, KeyTraits> mph_;
+    std::vector<Entry> entries_;
+    // set for positions whose hash is shared with entries in overflow_
+    std::vector<bool> has_overflow_;
+    std::vector<std::pair<unsigned, Entry>> overflow_;
+
+   public:
+    PerfectHashMap() = default;
+
+    // Returns false if no perfect hash could be found for the keys.
+    bool build(const HashMap<K, V, KeyTraits>& map) {
+        *this = PerfectHashMap();
+
+        std::vector<unsigned> hashes;
+        hashes.reserve(map.size());
+        for (const auto& entry : map) {
+            hashes.push_back(KeyTraits::hash(entry.key));
+        }
+        if (!mph_.build_from_hashes(hashes)) return false;
+
+        struct Placed {
+            std::size_t pos;
+            unsigned hash;
+            const K* key;
+            const V* value;
+        };
+        std::vector<Placed> placed;
+        placed.reserve(map.size());
+        std::size_t i = 0;
+        for (const auto& entry : map) {
+            auto hash = hashes[i++];
+            placed.push_back({mph_.index_for_hash(hash), hash, &entry.key,
+                              &entry.value});
+        }
+        std::sort(placed.begin(), placed.end(),
+                  [](auto& a, auto& b) { return a.pos < b.pos; });
+
+        entries_.reserve(mph_.size());
+        has_overflow_.assign(mph_.size(), false);
+        for (std::size_t j = 0; j < placed.size(); ++j) {
+            const auto& p = placed[j];
+            if (j > 0 && placed[j - 1].pos == p.pos) {
+                has_overflow_[p.pos] = true;
+                overflow_.push_back({p.hash, Entry{*p.key, *p.value}});
+            } else {
+                entries_.push_back(Entry{*p.key, *p.value});
+            }
+        }
+        std::sort(overflow_.begin(), overflow_.end(),
+                  [](auto& a, auto& b) { return a.first < b.first; });
+
+        return true;
+    }
+
+    [[nodiscard]] bool empty() const { return size() == 0; }
+    std::size_t size() const { return entries_.size() + overflow_.size(); }
+
+    const V* find(const K& key) const {
+        if (entries_.empty()) return nullptr;
+
+        auto hash = KeyTraits::hash(key);
+        auto pos = mph_.index_for_hash(hash);
+        const auto& entry = entries_[pos];
+        if (KeyTraits::equals(key, entry.key)) return &entry.value;
+        if (!has_overflow_[pos]) return nullptr;
+
+        auto it = std::lower_bound(
+            overflow_.begin(), overflow_.end(), hash,
+            [](auto& item, unsigned h) { return item.first < h; });
+        for (; it != overflow_.end() && it->first == hash; ++it) {
+            if (KeyTraits::equals(key, it->second.key)) {
+                return &it->second.value;
+            }
+        }
+        return nullptr;
+    }
+
+    bool contains(const K& key) const { return find(key) != nullptr; }
+};
+}  // namespace hashfu
@@ -0,0 +1,302 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "HashMap.h"
+
+namespace hashfu {
+
+template <typename Map, typename Key, typename Value, typename LargeIterator>
+class SmallHashMapIterator {
+    friend Map;
+
+    Map* map_{nullptr};
+    // inline entry, while the map is small
+    std::size_t index_{0};
+    // entry of the map's HashMap, once promoted
+    LargeIterator large_{};
+
+    SmallHashMapIterator(Map* map, std::size_t index, LargeIterator large)
+        : map_(map), index_(index), large_(large) {}
+
+   public:
+    // keys and values live in different arrays, so there is no entry to
+    // point at; dereferencing yields a pair of references instead
+    struct Reference {
+        const Key& key;
+        Value& value;
+    };
+    struct Pointer {
+        Reference ref;
+        Reference* operator->() { return &ref; }
+    };
+
+    SmallHashMapIterator() = default;
+
+    friend bool operator==(const SmallHashMapIterator& lhs,
+                           const SmallHashMapIterator& rhs) {
+        return lhs.index_ == rhs.index_ && lhs.large_ == rhs.large_;
+    }
+    friend bool operator!=(const SmallHashMapIterator& lhs,
+                           const SmallHashMapIterator& rhs) {
+        return !(lhs == rhs);
+    }
+
+    Reference operator*() {
+        if (map_->promoted_) return {large_->key, large_->value};
+        return {*map_->key_at(index_), *map_->value_at(index_)};
+    }
+    Pointer operator->() { return {**this}; }
+
+    void operator++() {
+        if (map_->promoted_) {
+            ++large_;
+        } else {
+            ++index_;
+        }
+    }
+};
+
+/* Map holding up to N entries inline, without touching the heap. Small maps
+ * are searched by comparing the key against every stored key, with no
+ * hashing at all; inserting entry N + 1 moves everything into a regular
+ * HashMap, which the map then keeps using until clear().
+ *
+ * The inline keys and values are kept in two separate arrays, so the scan
+ * reads nothing but keys. Keys of 1, 2, 4, 8, 16 or 32 bytes whose
+ * KeyTraits declare
+ *     static constexpr bool bitwise_equals = true;
+ * (equals() compares the bytes, as for integers, UUIDs and digests under
+ * DefaultTraits) are compared a key at a time with no early exit while
+ * there are only a few of them, then several at a time with the widest of
+ * SSE2, AVX2 and AVX-512 the CPU has; see detail::find_key().
+ *
+ * Iterators yield {key, value} references, as SoAHashMap's do; inserts
+ * and removes invalidate them.
+ */
+template <typename K, typename V, typename KeyTraits = DefaultTraits<K>,
+          std::size_t N = 8>
+class SmallHashMap {
+    static_assert(N > 0 && N <= 64, "inline capacity must be in [1, 64]");
+
+    template <typename, typename, typename, typename>
+    friend class SmallHashMapIterator;
+
+    using Large = HashMap<K, V, KeyTraits>;
+
+    static constexpr bool vector_scan =
+        detail::has_bitwise_equals_v<KeyTraits> &&
+        detail::find_key_vectorized(sizeof(K));
+    static constexpr bool nothrow_move =
+        std::is_nothrow_move_constructible_v<K> &&
+        std::is_nothrow_move_constructible_v<V>;
+
+    alignas(K) unsigned char keys_[N][sizeof(K)];
+    alignas(V) unsigned char values_[N][sizeof(V)];
+    // number of inline entries; unused once promoted
+    std::size_t size_{0};
+    bool promoted_{false};
+    Large large_;
+
+   public:
+    using Iterator =
+        SmallHashMapIterator<SmallHashMap, K, V, typename Large::Iterator>;
+    using ConstIterator =
+        SmallHashMapIterator<const SmallHashMap, K, const V,
+                             typename Large::ConstIterator>;
+
+    SmallHashMap() = default;
+    ~SmallHashMap() { destroy_inline(); }
+
+    SmallHashMap(const SmallHashMap& other)
+        : promoted_(other.promoted_), large_(other.large_) {
+        for (; size_ < other.size_; ++size_) {
+            new (key_at(size_)) K(*other.key_at(size_));
+            new (value_at(size_)) V(*other.value_at(size_));
+        }
+    }
+    SmallHashMap& operator=(const SmallHashMap& other) {
+        if (this != &other) {
+            SmallHashMap temp(other);
+            swap(*this, temp);
+        }
+        return *this;
+    }
+
+    SmallHashMap(SmallHashMap&& other) noexcept(nothrow_move) {
+        take(other);
+    }
+    SmallHashMap& operator=(SmallHashMap&& other) noexcept(nothrow_move) {
+        if (this != &other) {
+            clear();
+            take(other);
+        }
+        return *this;
+    }
+
+    friend void swap(SmallHashMap& a, SmallHashMap& b) noexcept(nothrow_move) {
+        SmallHashMap temp(std::move(a));
+        a = std::move(b);
+        b = std::move(temp);
+    }
+
+    [[nodiscard]] bool empty() const { return size() == 0; }
+    std::size_t size() const { return promoted_ ? large_.size() : size_; }
+    // whether the entries still live inline
+    bool is_small() const { return !promoted_; }
+    static constexpr std::size_t inline_capacity() { return N; }
+
+    Iterator begin() noexcept { return Iterator(this, 0, large_.begin()); }
+    Iterator end() noexcept {
+        return Iterator(this, promoted_ ? 0 : size_, large_.end());
+    }
+    ConstIterator begin() const noexcept {
+        return ConstIterator(this, 0, large_.begin());
+    }
+    ConstIterator end() const noexcept {
+        return ConstIterator(this, promoted_ ? 0 : size_, large_.end());
+    }
+    ConstIterator cbegin() const noexcept { return begin(); }
+    ConstIterator cend() const noexcept { return end(); }
+
+    void clear() {
+        destroy_inline();
+        size_ = 0;
+        promoted_ = false;
+        large_.clear();
+    }
+
+    // Returns the value stored for `key`, or nullptr.
+    V* find(const K& key) {
+        if (promoted_) {
+            auto it = large_.find(key);
+            return it != large_.end() ? &it->value : nullptr;
+        }
+
+        auto index = scan(key);
+        return index < size_ ? value_at(index) : nullptr;
+    }
+    const V* find(const K& key) const {
+        return const_cast<SmallHashMap*>(this)->find(key);
+    }
+
+    bool contains(const K& key) const { return find(key) != nullptr; }
+
+    HashTableResult insert(const K& key, const V& value) {
+        if (promoted_) return large_.insert(key, value);
+
+        auto index = scan(key);
+        if (index < size_) {
+            *value_at(index) = value;
+            return HashTableResult::ReplacedExistingEntry;
+        }
+
+        if (size_ == N) {
+            promote();
+            return large_.insert(key, value);
+        }
+
+        new (key_at(size_)) K(key);
+        new (value_at(size_)) V(value);
+        ++size_;
+        return HashTableResult::InsertedNewEntry;
+    }
+
+    bool remove(const K& key) {
+        if (promoted_) return large_.remove(key);
+
+        auto index = scan(key);
+        if (index >= size_) return false;
+
+        // keep the inline entries packed by moving the last one down
+        --size_;
+        if (index != size_) {
+            *key_at(index) = std::move(*key_at(size_));
+            *value_at(index) = std::move(*value_at(size_));
+        }
+        key_at(size_)->~K();
+        value_at(size_)->~V();
+        return true;
+    }
+
+    V& operator[](const K& key) {
+        if (auto* value = find(key)) return *value;
+
+        insert(key, V());
+        return *find(key);
+    }
+
+    // Calls fn(key, value) for every entry.
+    template <typename Fn>
+    void for_each(Fn fn) {
+        if (promoted_) {
+            for (auto& entry : large_) fn(entry.key, entry.value);
+            return;
+        }
+        for (std::size_t i = 0; i < size_; ++i) {
+            fn(static_cast<const K&>(*key_at(i)), *value_at(i));
+        }
+    }
+    template <typename Fn>
+    void for_each(Fn fn) const {
+        if (promoted_) {
+            for (const auto& entry : large_) fn(entry.key, entry.value);
+            return;
+        }
+        for (std::size_t i = 0; i < size_; ++i) fn(*key_at(i), *value_at(i));
+    }
+
+   private:
+    K* key_at(std::size_t i) { return reinterpret_cast<K*>(keys_[i]); }
+    const K* key_at(std::size_t i) const {
+        return reinterpret_cast<const K*>(keys_[i]);
+    }
+    V* value_at(std::size_t i) { return reinterpret_cast<V*>(values_[i]); }
+    const V* value_at(std::size_t i) const {
+        return reinterpret_cast<const V*>(values_[i]);
+    }
+
+    // index of the inline entry holding `key`, size_ if there is none
+    std::size_t scan(const K& key) const {
+        if constexpr (vector_scan) {
+            return detail::find_key<sizeof(K)>(&keys_[0][0], size_, &key);
+        } else {
+            for (std::size_t i = 0; i < size_; ++i) {
+                if (KeyTraits::equals(*key_at(i), key)) return i;
+            }
+            return size_;
+        }
+    }
+
+    void promote() {
+        large_.reserve(N + 1);
+        for (std::size_t i = 0; i < size_; ++i) {
+            large_.insert(*key_at(i), *value_at(i));
+        }
+        destroy_inline();
+        size_ = 0;
+        promoted_ = true;
+    }
+
+    // moves the contents of `other` into this empty map and clears it
+    void take(SmallHashMap& other) {
+        promoted_ = other.promoted_;
+        large_ = std::move(other.large_);
+        for (; size_ < other.size_; ++size_) {
+            new (key_at(size_)) K(std::move(*other.key_at(size_)));
+            new (value_at(size_)) V(std::move(*other.value_at(size_)));
+        }
+        other.clear();
+    }
+
+    void destroy_inline() {
+        for (std::size_t i = 0; i < size_; ++i) {
+            key_at(i)->~K();
+            value_at(i)->~V();
+        }
+    }
+};
+}  // namespace hashfu
@@ -0,0 +1,324 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <utility>
+
+#include "HashTable.h"
+
+namespace hashfu {
+
+template <typename Map, typename Key, typename Value>
+class SoAHashMapIterator {
+    friend Map;
+
+    Map* map_{nullptr};
+    std::size_t index_{0};
+
+    SoAHashMapIterator(Map* map, std::size_t index)
+        : map_(map), index_(index) {}
+
+   public:
+    // keys and values live in different arrays, so there is no entry to
+    // point at; dereferencing yields a pair of references instead
+    struct Reference {
+        const Key& key;
+        Value& value;
+    };
+    struct Pointer {
+        Reference ref;
+        Reference* operator->() { return &ref; }
+    };
+
+    SoAHashMapIterator() = default;
+
+    friend bool operator==(const SoAHashMapIterator& lhs,
+                           const SoAHashMapIterator& rhs) {
+        return lhs.index_ == rhs.index_;
+    }
+    friend bool operator!=(const SoAHashMapIterator& lhs,
+                           const SoAHashMapIterator& rhs) {
+        return lhs.index_ != rhs.index_;
+    }
+
+    Reference operator*() const {
+        return {map_->key_at(index_), map_->value_at(index_)};
+    }
+    Pointer operator->() const { return {**this}; }
+
+    void operator++() { index_ = map_->next_used(index_ + 1); }
+};
+
+/* HashMap with a struct-of-arrays layout: the probe sequence runs over an
+ * array holding only the keys and their bucket state, and the values sit
+ * in a parallel array that is touched once, on a hit. With large values
+ * this keeps several keys per cache line during probing, where HashMap
+ * strides over sizeof(V) bytes per bucket.
+ *
+ * Probing, tombstones and growth are HashTable's, from the detail::probe_*
+ * helpers. Seeded KeyTraits get a random seed per map, as in HashTable;
+ * the map doesn't reseed.
+ */
+template <typename K, typename V, typename KeyTraits = DefaultTraits<K>>
+class SoAHashMap {
+    template <typename, typename, typename>
+    friend class SoAHashMapIterator;
+
+    struct KeySlot {
+        bool used;
+        bool deleted;
+        alignas(K) unsigned char storage[sizeof(K)];
+
+        K* key() { return reinterpret_cast<K*>(storage); }
+        const K* key() const { return reinterpret_cast<const K*>(storage); }
+    };
+    struct ValueSlot {
+        alignas(V) unsigned char storage[sizeof(V)];
+
+        V* value() { return reinterpret_cast<V*>(storage); }
+        const V* value() const { return reinterpret_cast<const V*>(storage); }
+    };
+
+    KeySlot* keys_{nullptr};
+    ValueSlot* values_{nullptr};
+    std::size_t size_{0};
+    std::size_t deleted_count_{0};
+    std::size_t capacity_{0};
+    std::uint64_t seed_{detail::has_seeded_hash_v<KeyTraits, K>
+                            ? detail::new_table_seed()
+                            : 0};
+
+   public:
+    using Iterator = SoAHashMapIterator<SoAHashMap, K, V>;
+    using ConstIterator = SoAHashMapIterator<const SoAHashMap, K, const V>;
+
+    SoAHashMap() = default;
+    ~SoAHashMap() {
+        destroy_all();
+        std::free(keys_);
+        std::free(values_);
+    }
+
+    SoAHashMap(const SoAHashMap& other) {
+        rehash(other.capacity_);
+        for (const auto& entry : other) insert(entry.key, entry.value);
+    }
+    SoAHashMap& operator=(const SoAHashMap& other) {
+        if (this != &other) {
+            SoAHashMap temp(other);
+            swap(*this, temp);
+        }
+        return *this;
+    }
+
+    SoAHashMap(SoAHashMap&& other) noexcept { swap(*this, other); }
+    SoAHashMap& operator=(SoAHashMap&& other) noexcept {
+        swap(*this, other);
+        return *this;
+    }
+
+    friend void swap(SoAHashMap& a, SoAHashMap& b) noexcept {
+        std::swap(a.keys_, b.keys_);
+        std::swap(a.values_, b.values_);
+        std::swap(a.size_, b.size_);
+        std::swap(a.deleted_count_, b.deleted_count_);
+        std::swap(a.capacity_, b.capacity_);
+        std::swap(a.seed_, b.seed_);
+    }
+
+    [[nodiscard]] bool empty() const { return size_ == 0; }
+    std::size_t size() const { return size_; }
+    std::size_t capacity() const { return capacity_; }
+    float load_factor() const {
+        return static_cast<float>(size_ + deleted_count_) /
+               static_cast<float>(capacity_);
+    }
+
+    void clear() { *this = SoAHashMap(); }
+    // Grows the map so that `count` entries fit without another rehash.
+    void reserve(std::size_t count) {
+        if (detail::probing_fits(count, deleted_count_, capacity_)) return;
+
+        rehash(detail::probing_capacity_for(count));
+    }
+
+    Iterator begin() noexcept { return Iterator(this, next_used(0)); }
+    Iterator end() noexcept { return Iterator(this, capacity_); }
+    ConstIterator begin() const noexcept {
+        return ConstIterator(this, next_used(0));
+    }
+    ConstIterator end() const noexcept {
+        return ConstIterator(this, capacity_);
+    }
+    ConstIterator cbegin() const noexcept { return begin(); }
+    ConstIterator cend() const noexcept { return end(); }
+
+    Iterator find(const K& key) { return Iterator(this, lookup(key)); }
+    ConstIterator find(const K& key) const {
+        return ConstIterator(this, lookup(key));
+    }
+
+    bool contains(const K& key) const { return lookup(key) != capacity_; }
+
+    HashTableResult insert(const K& key, const V& value) {
+        auto index = lookup_for_writing(key);
+        if (index == capacity_) return HashTableResult::TableFull;
+        auto& slot = keys_[index];
+
+        if (slot.used) {
+            *values_[index].value() = value;
+            return HashTableResult::ReplacedExistingEntry;
+        }
+
+        new (slot.key()) K(key);
+        new (values_[index].value()) V(value);
+        if (slot.deleted) --deleted_count_;
+        slot.used = true;
+        slot.deleted = false;
+        ++size_;
+        return HashTableResult::InsertedNewEntry;
+    }
+
+    bool remove(const K& key) {
+        auto index = lookup(key);
+        if (index == capacity_) return false;
+
+        auto& slot = keys_[index];
+        slot.key()->~K();
+        values_[index].value()->~V();
+        slot.used = false;
+        slot.deleted = true;
+        --size_;
+        ++deleted_count_;
+        return true;
+    }
+
+    V& operator[](const K& key) {
+        auto index = lookup(key);
+        if (index == capacity_) {
+            insert(key, V());
+            index = lookup(key);
+            assert(index != capacity_);
+        }
+        return *values_[index].value();
+    }
+
+   private:
+    const K& key_at(std::size_t index) const { return *keys_[index].key(); }
+    V& value_at(std::size_t index) { return *values_[index].value(); }
+    const V& value_at(std::size_t index) const {
+        return *values_[index].value();
+    }
+
+    std::size_t home(const K& key) const {
+        return detail::hash_with<KeyTraits>(key, seed_) % capacity_;
+    }
+
+    std::size_t next_used(std::size_t index) const {
+        while (index < capacity_ && !keys_[index].used) ++index;
+        return index;
+    }
+
+    // index of the slot holding `key`, capacity_ if there is none
+    std::size_t lookup(const K& key) const {
+        if (empty()) return capacity_;
+
+        return detail::probe_find(keys_, capacity_, home(key),
+                                  [&key](const KeySlot& slot) {
+                                      return KeyTraits::equals(*slot.key(),
+                                                               key);
+                                  });
+    }
+
+    // slot to write `key` to, capacity_ if the map could not grow
+    std::size_t lookup_for_writing(const K& key) {
+        if (detail::probing_should_grow(size_ + deleted_count_, capacity_) &&
+            !rehash(capacity_ * 2)) {
+            return capacity_;
+        }
+
+        std::size_t probes;
+        return detail::probe_for_insert(keys_, capacity_, home(key),
+                                        [&key](const KeySlot& slot) {
+                                            return KeyTraits::equals(
+                                                *slot.key(), key);
+                                        },
+                                        probes);
+    }
+
+    // Returns false, leaving the map as it was, if out of memory.
+    bool rehash(std::size_t new_capacity) {
+        new_capacity = std::max(new_capacity, std::size_t{4});
+
+        auto* new_keys = allocate<KeySlot>(new_capacity);
+        auto* new_values = allocate<ValueSlot>(new_capacity);
+        if (!new_keys || !new_values) {
+            std::free(new_keys);
+            std::free(new_values);
+            return false;
+        }
+        std::memset(static_cast<void*>(new_keys), 0,
+                    sizeof(KeySlot) * new_capacity);
+
+        auto* old_keys = keys_;
+        auto* old_values = values_;
+        auto old_capacity = capacity_;
+
+        keys_ = new_keys;
+        values_ = new_values;
+        capacity_ = new_capacity;
+        size_ = 0;
+        deleted_count_ = 0;
+
+        for (std::size_t i = 0; i < old_capacity; ++i) {
+            auto& slot = old_keys[i];
+            if (!slot.used) continue;
+
+            auto index = free_index(*slot.key());
+            new (keys_[index].key()) K(std::move(*slot.key()));
+            new (values_[index].value()) V(std::move(*old_values[i].value()));
+            keys_[index].used = true;
+            ++size_;
+
+            slot.key()->~K();
+            old_values[i].value()->~V();
+        }
+
+        std::free(old_keys);
+        std::free(old_values);
+        return true;
+    }
+
+    // cache line aligned, as HashTable's buckets, or more if Slot needs it
+    template <typename Slot>
+    static Slot* allocate(std::size_t count) {
+        constexpr std::size_t alignment =
+            std::max<std::size_t>(64, alignof(Slot));
+        auto bytes =
+            (sizeof(Slot) * count + alignment - 1) / alignment * alignment;
+        return static_cast<Slot*>(std::aligned_alloc(alignment, bytes));
+    }
+
+    // first free slot for a key known not to be in the freshly built table
+    std::size_t free_index(const K& key) const {
+        std::size_t probes;
+        return detail::probe_for_insert(
+            keys_, capacity_, home(key),
+            [](const KeySlot&) { return false; }, probes);
+    }
+
+    void destroy_all() {
+        for (std::size_t i = 0; i < capacity_; ++i) {
+            if (!keys_[i].used) continue;
+
+            keys_[i].key()->~K();
+            values_[i].value()->~V();
+        }
+    }
+};
+}  // namespace hashfu
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+#include "HashTable.h"
+
+namespace hashfu {
+
+/* Fixed-capacity map whose slots are embedded in the object, for code that
+ * may neither allocate nor stall on a rehash. Nothing here ever touches the
+ * heap: try_insert() reports HashTableResult::TableFull instead of growing.
+ *
+ * Worst-case cost is bounded at compile time. Every entry is stored at most
+ * MaxProbe - 1 slots past the one its hash maps to: try_insert() gives up
+ * rather than place an entry further out, and remove() shifts the entries
+ * behind the removed one back instead of leaving a tombstone, which only
+ * ever moves entries closer to home. So find() and try_insert() look at no
+ * more than MaxProbe slots, however full the map is and however many
+ * removals it has seen. remove() does the same lookup, then scans on for
+ * at most MaxProbe - 1 slots past each entry it shifts back.
+ *
+ * Probes can fail before the map is full when hashes cluster; keeping the
+ * map at most ~70% full leaves the default bound (32 slots, or Capacity if
+ * that is smaller) plenty of slack.
+ */
+template <typename K, typename V, typename KeyTraits, std::size_t Capacity,
+          std::size_t MaxProbe = (Capacity < 32 ? Capacity : 32)>
+class StaticHashMap {
+    static_assert(Capacity > 0, "StaticHashMap needs at least one slot");
+    static_assert(MaxProbe > 0 && MaxProbe <= Capacity,
+                  "MaxProbe must be in [1, Capacity]");
+
+    struct Entry {
+        K key;
+        V value;
+    };
+    struct Slot {
+        bool used;
+        // cached so that remove() can find the home slot of shifted entries
+        unsigned hash;
+        alignas(Entry) unsigned char storage[sizeof(Entry)];
+
+        Entry* entry() { return reinterpret_cast<Entry*>(storage); }
+        const Entry* entry() const {
+            return reinterpret_cast<const Entry*>(storage);
+        }
+    };
+
+    Slot slots_[Capacity];
+    std::size_t size_{0};
+
+   public:
+    StaticHashMap() {
+        for (auto& slot : slots_) slot.used = false;
+    }
+    ~StaticHashMap() { clear(); }
+
+    // Copies keep every entry in the same slot, so they cannot fail.
+    StaticHashMap(const StaticHashMap& other) : StaticHashMap() {
+        for (std::size_t i = 0; i < Capacity; ++i) {
+            const auto& slot = other.slots_[i];
+            if (slot.used) place(i, slot.hash, *slot.entry());
+        }
+    }
+    StaticHashMap& operator=(const StaticHashMap& other) {
+        if (this != &other) {
+            clear();
+            for (std::size_t i = 0; i < Capacity; ++i) {
+                const auto& slot = other.slots_[i];
+                if (slot.used) place(i, slot.hash, *slot.entry());
+            }
+        }
+        return *this;
+    }
+
+    [[nodiscard]] bool empty() const { return size_ == 0; }
+    std::size_t size() const { return size_; }
+    static constexpr std::size_t capacity() { return Capacity; }
+    // most slots any single operation probes
+    static constexpr std::size_t max_probe_length() { return MaxProbe; }
+
+    void clear() {
+        for (auto& slot : slots_) {
+            if (!slot.used) continue;
+
+            slot.entry()->~Entry();
+            slot.used = false;
+        }
+        size_ = 0;
+    }
+
+    // Returns the value stored for `key`, or nullptr.
+    V* find(const K& key) {
+        auto index = lookup(key, KeyTraits::hash(key));
+        return index < Capacity ? &slots_[index].entry()->value : nullptr;
+    }
+    const V* find(const K& key) const {
+        auto index = lookup(key, KeyTraits::hash(key));
+        return index < Capacity ? &slots_[index].entry()->value : nullptr;
+    }
+
+    bool contains(const K& key) const { return find(key) != nullptr; }
+
+    /* Inserts or replaces like HashMap::insert(). Returns TableFull, leaving
+     * the map untouched, if none of the MaxProbe slots starting at the
+     * key's home slot is free. */
+    HashTableResult try_insert(const K& key, const V& value) {
+        auto hash = KeyTraits::hash(key);
+        auto index = home(hash);
+
+        for (std::size_t probe = 0; probe < MaxProbe; ++probe) {
+            auto& slot = slots_[index];
+
+            if (!slot.used) {
+                place(index, hash, Entry{key, value});
+                return HashTableResult::InsertedNewEntry;
+            }
+
+            if (slot.hash == hash &&
+                KeyTraits::equals(slot.entry()->key, key)) {
+                slot.entry()->value = value;
+                return HashTableResult::ReplacedExistingEntry;
+            }
+
+            index = next(index);
+        }
+
+        return HashTableResult::TableFull;
+    }
+
+    bool remove(const K& key) {
+        auto hole = lookup(key, KeyTraits::hash(key));
+        if (hole == Capacity) return false;
+
+        slots_[hole].entry()->~Entry();
+        --size_;
+
+        /* Backward shift: pull each following entry of the run into the
+         * hole unless that would put it before its home slot. Entries
+         * MaxProbe or more slots past the hole have their home past it too,
+         * so the scan can stop there. */
+        auto index = hole;
+        for (std::size_t distance = 1; distance < MaxProbe; ++distance) {
+            index = next(index);
+            auto& slot = slots_[index];
+            if (!slot.used) break;
+
+            auto slot_home = home(slot.hash);
+            bool movable = hole <= index
+                               ? (slot_home <= hole || slot_home > index)
+                               : (slot_home <= hole && slot_home > index);
+            if (!movable) continue;
+
+            auto& target = slots_[hole];
+            new (target.entry()) Entry(std::move(*slot.entry()));
+            target.hash = slot.hash;
+            slot.entry()->~Entry();
+            hole = index;
+            distance = 0;
+        }
+
+        slots_[hole].used = false;
+        return true;
+    }
+
+    // Calls fn(key, value) for every entry.
+    template <typename Fn>
+    void for_each(Fn fn) {
+        for (auto& slot : slots_) {
+            if (slot.used) fn(static_cast<const K&>(slot.entry()->key),
+                              slot.entry()->value);
+        }
+    }
+    template <typename Fn>
+    void for_each(Fn fn) const {
+        for (const auto& slot : slots_) {
+            if (slot.used) fn(slot.entry()->key, slot.entry()->value);
+        }
+    }
+
+   private:
+    static std::size_t home(unsigned hash) { return hash % Capacity; }
+    static std::size_t next(std::size_t index) {
+        return index + 1 == Capacity ? 0 : index + 1;
+    }
+
+    // index of the slot holding `key`, Capacity if there is none
+    std::size_t lookup(const K& key, unsigned hash) const {
+        auto index = home(hash);
+        for (std::size_t probe = 0; probe < MaxProbe; ++probe) {
+            const auto& slot = slots_[index];
+            if (!slot.used) break;
+
+            if (slot.hash == hash && KeyTraits::equals(slot.entry()->key, key))
+                return index;
+
+            index = next(index);
+        }
+        return Capacity;
+    }
+
+    void place(std::size_t index, unsigned hash, const Entry& entry) {
+        auto& slot = slots_[index];
+        new (slot.entry()) Entry(entry);
+        slot.hash = hash;
+        slot.used = true;
+        ++size_;
+    }
+};
+}  // namespace hashfu
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+
+#include "Arena.h"
+#include "HashTable.h"
+
+namespace hashfu {
+
+/* Map from strings to V that copies every key into an Arena owned by the
+ * map, so a key costs its bytes and no heap allocation of its own. Buckets
+ * hold a 16-byte handle (pointer, length, hash) next to the value, and
+ * rehashing moves handles without reading the keys.
+ *
+ * KeyTraits works on std::string_view, and lookups take any
+ * std::string_view, so there is no need to build a std::string to query
+ * the map. remove() does not give the key's bytes back to the arena;
+ * clear() releases all of them.
+ *
+ * Seeded KeyTraits get a random seed per map, as in HashTable, but since
+ * the buckets cache the hashes the map never reseeds.
+ */
+template <typename V,
+          typename KeyTraits = DefaultTraits<std::string_view>>
+class StringHashMap {
+   public:
+    struct Entry {
+        const char* key_data;
+        std::uint32_t key_size;
+        std::uint32_t hash;
+        V value;
+
+        std::string_view key() const { return {key_data, key_size}; }
+    };
+
+   private:
+    struct EntryTraits {
+        static unsigned hash(const Entry& e) { return e.hash; }
+        static bool equals(const Entry& a, const Entry& b) {
+            return a.hash == b.hash && KeyTraits::equals(a.key(), b.key());
+        }
+    };
+    using HashTableType = HashTable<Entry, EntryTraits>;
+
+    // whether KeyTraits::hash takes the map's seed
+    static constexpr bool seeded =
+        detail::has_seeded_hash_v<KeyTraits, std::string_view>;
+
+    HashTableType table_;
+    Arena arena_;
+    std::uint64_t seed_{seeded ? detail::new_table_seed() : 0};
+
+   public:
+    using Iterator = typename HashTableType::Iterator;
+    using ConstIterator = typename HashTableType::ConstIterator;
+
+    StringHashMap() = default;
+
+    StringHashMap(const StringHashMap& other) {
+        reserve(other.size());
+        for (const auto& entry : other) insert(entry.key(), entry.value);
+    }
+    StringHashMap& operator=(const StringHashMap& other) {
+        if (this != &other) {
+            StringHashMap temp(other);
+            swap(*this, temp);
+        }
+        return *this;
+    }
+
+    StringHashMap(StringHashMap&& other) noexcept { swap(*this, other); }
+    StringHashMap& operator=(StringHashMap&& other) noexcept {
+        swap(*this, other);
+        return *this;
+    }
+
+    friend void swap(StringHashMap& a, StringHashMap& b) noexcept {
+        a.table_.swap(a.table_, b.table_);
+        swap(a.arena_, b.arena_);
+        std::swap(a.seed_, b.seed_);
+    }
+
+    [[nodiscard]] bool empty() const { return table_.empty(); }
+    size_t size() const { return table_.size(); }
+    size_t capacity() const { return table_.capacity(); }
+    float load_factor() const { return table_.load_factor(); }
+    // bytes held by the key arena
+    size_t key_bytes_reserved() const { return arena_.bytes_reserved(); }
+
+    void clear() {
+        table_.clear();
+        arena_.clear();
+    }
+    void reserve(size_t count) { table_.reserve(count); }
+
+    Iterator begin() noexcept { return table_.begin(); }
+    Iterator end() noexcept { return table_.end(); }
+    ConstIterator begin() const noexcept { return table_.begin(); }
+    ConstIterator end() const noexcept { return table_.end(); }
+    ConstIterator cbegin() const noexcept { return begin(); }
+    ConstIterator cend() const noexcept { return end(); }
+
+    Iterator find(std::string_view key) {
+        return find_with_hash(key, hash_of(key));
+    }
+    ConstIterator find(std::string_view key) const {
+        auto hash = hash_of(key);
+        return table_.find(hash, [&](const Entry& e) {
+            return e.hash == hash && KeyTraits::equals(e.key(), key);
+        });
+    }
+
+    bool contains(std::string_view key) const { return find(key) != end(); }
+
+    HashTableResult insert(std::string_view key, const V& value) {
+        auto hash = hash_of(key);
+        auto it = find_with_hash(key, hash);
+        if (it != end()) {
+            it->value = value;
+            return HashTableResult::ReplacedExistingEntry;
+        }
+
+        assert(key.size() <= std::numeric_limits<std::uint32_t>::max());
+        auto stored = arena_.copy(key);
+        return table_.insert_with_hash(
+            hash, {stored.data(), static_cast<std::uint32_t>(stored.size()),
+                   static_cast<std::uint32_t>(hash), value});
+    }
+
+    bool remove(std::string_view key) {
+        auto it = find(key);
+        if (it == end()) return false;
+
+        table_.remove(it);
+        return true;
+    }
+
+    V& operator[](std::string_view key) {
+        auto it = find(key);
+        if (it == end()) insert(key, V());
+        return find(key)->value;
+    }
+
+   private:
+    unsigned hash_of(std::string_view key) const {
+        return detail::hash_with<KeyTraits>(key, seed_);
+    }
+
+    Iterator find_with_hash(std::string_view key, unsigned hash) {
+        return table_.find(hash, [&](const Entry& e) {
+            return e.hash == hash && KeyTraits::equals(e.key(), key);
+        });
+    }
+};
+}  // namespace hashfu
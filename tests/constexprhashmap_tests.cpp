@@ -0,0 +1,73 @@
+#include "ConstexprHashMap.h"
+#include "catch.hpp"
+
+using hashfu::ConstexprHashMap;
+using hashfu::make_constexpr_hash_map;
+using hashfu::StringViewTraits;
+
+static constexpr auto keywords =
+    make_constexpr_hash_map<std::string_view, int, StringViewTraits>(
+        {{"if", 1}, {"else", 2}, {"while", 3}, {"for", 4}, {"return", 5}});
+
+// all of this is checked at compile time
+static_assert(keywords.size() == 5);
+static_assert(keywords.capacity() == 16);
+static_assert(*keywords.find("if") == 1);
+static_assert(*keywords.find("return") == 5);
+static_assert(!keywords.contains("goto"));
+static_assert(StringViewTraits::hash("") == 2166136261u);
+
+struct TraitsForInt {
+    static constexpr unsigned hash(int val) {
+        return static_cast<unsigned>(val);
+    }
+    static constexpr bool equals(int a, int b) { return a == b; }
+};
+
+TEST_CASE("Runtime lookups") {
+    for (auto word : {"if", "else", "while", "for", "return"}) {
+        REQUIRE(keywords.contains(word));
+    }
+    REQUIRE(*keywords.find("while") == 3);
+
+    std::string dynamic = "for";
+    REQUIRE(*keywords.find(dynamic) == 4);
+    REQUIRE_FALSE(keywords.contains(dynamic + "ever"));
+}
+
+TEST_CASE("Collisions and duplicates") {
+    // every key lands in slot 0 or 1 of the probe sequence
+    constexpr ConstexprHashMap<int, int, TraitsForInt, 8> map = {
+        {0, 10}, {8, 80}, {16, 160}, {1, 1}, {8, 81}};
+
+    static_assert(map.size() == 4);
+    static_assert(*map.find(0) == 10);
+    static_assert(*map.find(8) == 81);
+    static_assert(*map.find(16) == 160);
+    static_assert(*map.find(1) == 1);
+    static_assert(!map.contains(24));
+
+    REQUIRE(*map.find(16) == 160);
+    REQUIRE_FALSE(map.contains(9));
+}
+
+TEST_CASE("Empty") {
+    constexpr ConstexprHashMap<int, int, TraitsForInt, 1> map;
+    static_assert(map.empty());
+    static_assert(!map.contains(0));
+    REQUIRE(map.find(0) == nullptr);
+}
+
+TEST_CASE("Filled at runtime") {
+    ConstexprHashMap<int, int, TraitsForInt, 4> map;
+    for (int i = 0; i < 3; ++i) REQUIRE(map.insert(i * 4, i));
+
+    // the last slot stays empty, so that misses still end
+    REQUIRE_FALSE(map.insert(1, 1));
+    REQUIRE(map.size() == 3u);
+    REQUIRE_FALSE(map.contains(1));
+    REQUIRE_FALSE(map.contains(12));
+
+    REQUIRE(map.insert(4, 40));
+    REQUIRE(*map.find(4) == 40);
+}
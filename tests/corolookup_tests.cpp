@@ -0,0 +1,76 @@
+#include "CoroLookup.h"
+#include "catch.hpp"
+
+struct TraitsForInt {
+    static unsigned hash(const int& val) { return std::hash<int>{}(val); }
+    static bool equals(const int& a, const int& b) { return a == b; }
+};
+
+using hashfu::HashTable;
+
+using IntTable = HashTable<int, TraitsForInt>;
+using Lookup = hashfu::CoroLookup<IntTable>;
+
+TEST_CASE("Empty table") {
+    const IntTable table;
+    const int values[] = {1, 2, 3};
+    IntTable::ConstIterator found[3];
+    bool present[3] = {true, true, true};
+
+    Lookup::find(table, values, 3, found);
+    Lookup::contains(table, values, 3, present);
+
+    for (int i = 0; i < 3; ++i) {
+        REQUIRE(found[i] == table.end());
+        REQUIRE_FALSE(present[i]);
+    }
+}
+
+TEST_CASE("Matches plain find") {
+    IntTable mutable_table;
+    for (int i = 0; i < 1000; i += 2) {
+        mutable_table.insert(i);
+    }
+    const auto& table = mutable_table;
+
+    std::vector<int> values;
+    for (int i = 0; i < 1000; ++i) {
+        values.push_back(i);
+    }
+
+    for (size_t width : {1, 3, 16, 64}) {
+        std::vector<IntTable::ConstIterator> found(values.size());
+        Lookup::find(table, values.data(), values.size(), found.data(), width);
+
+        for (size_t i = 0; i < values.size(); ++i) {
+            REQUIRE(found[i] == table.find(values[i]));
+        }
+    }
+}
+
+TEST_CASE("Long probe sequences") {
+    // every value collides, so lookups have to walk across many cache lines
+    struct CollisionTraits {
+        static unsigned hash(const int&) { return 0; }
+        static bool equals(const int& a, const int& b) { return a == b; }
+    };
+    using CollisionTable = HashTable<int, CollisionTraits>;
+
+    CollisionTable table;
+    for (int i = 0; i < 300; ++i) {
+        table.insert(i);
+    }
+    REQUIRE(table.remove(150));
+
+    std::vector<int> values{299, 0, 150, 1000, 42, 298};
+    bool present[6];
+    hashfu::CoroLookup<CollisionTable>::contains(table, values.data(),
+                                                 values.size(), present);
+
+    REQUIRE(present[0]);
+    REQUIRE(present[1]);
+    REQUIRE_FALSE(present[2]);
+    REQUIRE_FALSE(present[3]);
+    REQUIRE(present[4]);
+    REQUIRE(present[5]);
+}
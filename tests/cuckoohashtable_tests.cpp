@@ -0,0 +1,67 @@
+#include <set>
+
+#include "CuckooHashTable.h"
+#include "catch.hpp"
+
+// The API tests shared with HopscotchHashTable are in
+// displacingtable_tests.cpp.
+
+using hashfu::CuckooHashTable;
+
+using IntTable = CuckooHashTable<std::uint64_t>;
+
+TEST_CASE("Buckets fit a cache line") {
+    struct Pair {
+        std::uint64_t key, value;
+    };
+    struct PairTraits {
+        static unsigned hash(const Pair& p) {
+            return hashfu::DefaultTraits<std::uint64_t>::hash(p.key);
+        }
+        static bool equals(const Pair& a, const Pair& b) {
+            return a.key == b.key;
+        }
+    };
+    using PairTable = CuckooHashTable<Pair, PairTraits>;
+    static_assert(IntTable::slots_per_bucket == 7);
+    static_assert(PairTable::slots_per_bucket == 3);
+    static_assert(hashfu::detail::cuckoo_bucket_bytes<Pair>(3) <= 64);
+
+    // fewer slots still reach the load factor they advertise
+    PairTable table;
+    table.reserve(50000);
+    auto capacity = table.capacity();
+    auto fits = capacity * PairTable::load_factor_percent / 100;
+    for (std::uint64_t i = 0; i < fits; ++i) table.insert({i * 977, i});
+    REQUIRE(table.capacity() == capacity);
+    REQUIRE(table.size() == fits);
+    for (std::uint64_t i = 0; i < fits; ++i) {
+        REQUIRE(table.find({i * 977, 0})->value == i);
+    }
+}
+
+TEST_CASE("Mixed inserts and removes") {
+    // removes leave free slots all over a full table, which the moves of
+    // later inserts have to find
+    CuckooHashTable<std::uint64_t, hashfu::DefaultTraits<std::uint64_t>, 8>
+        table;
+    std::set<std::uint64_t> expected;
+
+    for (std::uint64_t i = 0; i < 20000; ++i) {
+        auto key = (i * 7919) % 30011;
+        if (i % 3 == 2) {
+            REQUIRE(table.remove(key) == (expected.erase(key) == 1));
+        } else {
+            table.insert(key);
+            expected.insert(key);
+        }
+    }
+    REQUIRE(table.size() == expected.size());
+
+    std::set<std::uint64_t> iterated;
+    for (auto key : table) iterated.insert(key);
+    REQUIRE(iterated == expected);
+    for (std::uint64_t key = 0; key < 30011; ++key) {
+        REQUIRE(table.contains(key) == (expected.count(key) == 1));
+    }
+}
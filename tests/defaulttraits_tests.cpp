@@ -0,0 +1,256 @@
+#include <algorithm>
+#include <array>
+#include <set>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "HashMap.h"
+#include "catch.hpp"
+
+using hashfu::DefaultTraits;
+using hashfu::HashMap;
+using hashfu::HashTable;
+
+struct Point {
+    int x, y;
+};
+
+enum class Color { Red, Green };
+
+TEST_CASE("Integers spread over buckets") {
+    // strided keys collide constantly under an identity hash
+    constexpr unsigned buckets = 64;
+    std::set<unsigned> used;
+    for (std::uint64_t i = 0; i < 64; ++i) {
+        used.insert(DefaultTraits<std::uint64_t>::hash(i << 20) % buckets);
+    }
+    REQUIRE(used.size() > 32u);
+
+    REQUIRE(DefaultTraits<int>::hash(42) == DefaultTraits<int>::hash(42));
+    REQUIRE(DefaultTraits<int>::hash(42) != DefaultTraits<int>::hash(43));
+    REQUIRE(DefaultTraits<int>::bitwise_equals);
+    REQUIRE(DefaultTraits<Color>::equals(Color::Red, Color::Red));
+    REQUIRE_FALSE(DefaultTraits<Color>::equals(Color::Red, Color::Green));
+
+    int a = 0, b = 0;
+    REQUIRE(DefaultTraits<int*>::hash(&a) != DefaultTraits<int*>::hash(&b));
+}
+
+TEST_CASE("Flipping any input bit changes about half the hash bits") {
+    for (int bit = 0; bit < 64; ++bit) {
+        int total = 0;
+        for (std::uint64_t key = 1; key <= 100; ++key) {
+            auto a = DefaultTraits<std::uint64_t>::hash(key * 0x9e3779b9);
+            auto b = DefaultTraits<std::uint64_t>::hash((key * 0x9e3779b9) ^
+                                                        (1ull << bit));
+            total += __builtin_popcount(a ^ b);
+        }
+        // 16 of 32 bits on average
+        REQUIRE(total > 1300);
+        REQUIRE(total < 1900);
+    }
+}
+
+template <typename I>
+static void check_batch_kernels(I first) {
+    std::vector<I> keys;
+    for (int i = 0; i < 40; ++i) {
+        keys.push_back(static_cast<I>(first + static_cast<I>(i * 7919)));
+    }
+    std::vector<unsigned> expected(keys.size()), got(keys.size());
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        expected[i] = DefaultTraits<I>::hash(keys[i]);
+    }
+
+    using Kernel = void (*)(const I*, std::size_t, unsigned*);
+    std::vector<Kernel> kernels = {hashfu::detail::fmix64_batch_scalar<I>,
+                                   DefaultTraits<I>::hash_batch};
+#ifdef HASHFU_X86_KERNELS
+    if (__builtin_cpu_supports("avx2"))
+        kernels.push_back(hashfu::detail::fmix64_batch_avx2<I>);
+    if (__builtin_cpu_supports("avx512f") &&
+        __builtin_cpu_supports("avx512dq"))
+        kernels.push_back(hashfu::detail::fmix64_batch_avx512<I>);
+#endif
+
+    // every length, so that each kernel's scalar tail gets exercised
+    for (auto kernel : kernels) {
+        for (std::size_t n = 0; n <= keys.size(); ++n) {
+            std::fill(got.begin(), got.end(), 0u);
+            kernel(keys.data(), n, got.data());
+            for (std::size_t i = 0; i < n; ++i) REQUIRE(got[i] == expected[i]);
+        }
+    }
+}
+
+TEST_CASE("Batch hashing matches hash()") {
+    check_batch_kernels<std::uint64_t>(0xfedcba9876543210ull);
+    check_batch_kernels<std::int64_t>(-100000);
+    check_batch_kernels<std::uint32_t>(0xfffff000u);
+    check_batch_kernels<std::int32_t>(-100);
+}
+
+TEST_CASE("Floating point") {
+    REQUIRE(DefaultTraits<double>::hash(0.0) ==
+            DefaultTraits<double>::hash(-0.0));
+    REQUIRE(DefaultTraits<double>::hash(1.5) !=
+            DefaultTraits<double>::hash(2.5));
+}
+
+TEST_CASE("Strings") {
+    using Traits = DefaultTraits<std::string>;
+    std::string long_key(1000, 'x');
+
+    REQUIRE(Traits::hash("") == Traits::hash(std::string()));
+    REQUIRE(Traits::hash("hello") == Traits::hash(std::string("hello")));
+    REQUIRE(Traits::hash("hello") == DefaultTraits<std::string_view>::hash(
+                                         std::string_view("hello, world", 5)));
+    REQUIRE(Traits::hash(long_key) == Traits::hash(std::string(1000, 'x')));
+
+    // every length takes a different path through the byte hash
+    std::set<unsigned> hashes;
+    for (std::size_t len = 0; len <= 100; ++len) {
+        hashes.insert(Traits::hash(long_key.substr(0, len)));
+    }
+    REQUIRE(hashes.size() == 101u);
+
+    long_key[999] = 'y';
+    REQUIRE(Traits::hash(long_key) != Traits::hash(std::string(1000, 'x')));
+}
+
+TEST_CASE("Pairs, tuples and aggregates") {
+    using PairTraits = DefaultTraits<std::pair<int, std::string>>;
+    REQUIRE(PairTraits::hash({1, "one"}) == PairTraits::hash({1, "one"}));
+    REQUIRE(PairTraits::hash({1, "one"}) != PairTraits::hash({2, "one"}));
+    REQUIRE(PairTraits::equals({1, "one"}, {1, "one"}));
+    REQUIRE_FALSE(PairTraits::equals({1, "one"}, {1, "two"}));
+
+    // order matters
+    using TupleTraits = DefaultTraits<std::tuple<int, int, int>>;
+    REQUIRE(TupleTraits::hash({1, 2, 3}) != TupleTraits::hash({3, 2, 1}));
+    REQUIRE(TupleTraits::equals({1, 2, 3}, {1, 2, 3}));
+
+    REQUIRE(DefaultTraits<Point>::hash({1, 2}) ==
+            DefaultTraits<Point>::hash({1, 2}));
+    REQUIRE(DefaultTraits<Point>::hash({1, 2}) !=
+            DefaultTraits<Point>::hash({2, 1}));
+    REQUIRE(DefaultTraits<Point>::equals({1, 2}, {1, 2}));
+}
+
+struct Uuid {
+    std::uint64_t high, low;
+};
+using Digest = std::array<std::uint8_t, 32>;
+struct Triple {
+    std::uint64_t a, b, c;
+};
+
+template <std::size_t N>
+static void check_find_key() {
+    using Kernel = std::size_t (*)(const unsigned char*, std::size_t,
+                                   const void*);
+    std::vector<Kernel> kernels = {hashfu::detail::find_key<N>,
+                                   hashfu::detail::find_key_scalar<N>,
+                                   hashfu::detail::find_key_few<N>};
+#ifdef HASHFU_X86_KERNELS
+    if constexpr (N <= 16 && hashfu::detail::find_key_vectorized(N)) {
+        kernels.push_back(hashfu::detail::find_key_sse2<N>);
+    }
+    if constexpr (hashfu::detail::find_key_vectorized(N)) {
+        if (__builtin_cpu_supports("avx2"))
+            kernels.push_back(hashfu::detail::find_key_avx2<N>);
+        if (__builtin_cpu_supports("avx512f") &&
+            __builtin_cpu_supports("avx512bw"))
+            kernels.push_back(hashfu::detail::find_key_avx512<N>);
+    }
+#endif
+
+    // keys differ in their first or last byte only, so a compare must see
+    // all of them; up to more keys than one AVX-512 compare of 1-byte keys
+    // covers, so that each kernel's vector loop and tail get exercised
+    constexpr std::size_t total = 70;
+    unsigned char keys[total * N] = {};
+    for (std::size_t i = 0; i < total; ++i) {
+        keys[i * N + (i % 2 ? N - 1 : 0)] = static_cast<unsigned char>(1 + i);
+    }
+
+    for (auto kernel : kernels) {
+        for (std::size_t count = 0; count <= total; ++count) {
+            for (std::size_t i = 0; i < total; ++i) {
+                auto expected = i < count ? i : count;
+                REQUIRE(kernel(keys, count, keys + i * N) == expected);
+            }
+            unsigned char missing[N] = {};
+            REQUIRE(kernel(keys, count, missing) == count);
+        }
+    }
+}
+
+TEST_CASE("32-byte compare kernels") {
+    using Kernel = bool (*)(const unsigned char*, const unsigned char*);
+    std::vector<Kernel> kernels;
+#ifdef HASHFU_X86_KERNELS
+    kernels.push_back(hashfu::detail::bytes_equal32_sse2);
+    if (__builtin_cpu_supports("avx2"))
+        kernels.push_back(hashfu::detail::bytes_equal32_avx2);
+#endif
+
+    unsigned char a[32] = {}, b[32] = {};
+    for (auto kernel : kernels) {
+        REQUIRE(kernel(a, b));
+        // a difference in any byte, in either half
+        for (std::size_t i = 0; i < 32; ++i) {
+            b[i] = 0x80;
+            REQUIRE_FALSE(kernel(a, b));
+            b[i] = 0;
+        }
+    }
+}
+
+TEST_CASE("Bytewise keys") {
+    using UuidTraits = DefaultTraits<Uuid>;
+    REQUIRE(UuidTraits::bitwise_equals);
+    REQUIRE(UuidTraits::equals({1, 2}, {1, 2}));
+    REQUIRE_FALSE(UuidTraits::equals({1, 2}, {1, 3}));
+    REQUIRE_FALSE(UuidTraits::equals({1, 2}, {1ull << 63, 2}));
+    REQUIRE(UuidTraits::hash({1, 2}) != UuidTraits::hash({2, 1}));
+
+    Digest a{}, b{};
+    b[31] = 1;
+    REQUIRE(DefaultTraits<Digest>::equals(a, a));
+    REQUIRE_FALSE(DefaultTraits<Digest>::equals(a, b));
+    b[31] = 0;
+    b[0] = 0x80;
+    REQUIRE_FALSE(DefaultTraits<Digest>::equals(a, b));
+    REQUIRE(DefaultTraits<Digest>::hash(a) != DefaultTraits<Digest>::hash(b));
+
+    REQUIRE(DefaultTraits<Triple>::equals({1, 2, 3}, {1, 2, 3}));
+    REQUIRE_FALSE(DefaultTraits<Triple>::equals({1, 2, 3}, {1, 2, 4}));
+
+    check_find_key<1>();
+    check_find_key<2>();
+    check_find_key<4>();
+    check_find_key<8>();
+    check_find_key<16>();
+    check_find_key<32>();
+    check_find_key<24>();
+}
+
+TEST_CASE("Default traits of HashTable and HashMap") {
+    HashTable<int> table;
+    for (int i = 0; i < 1000; ++i) table.insert(i << 10);
+    REQUIRE(table.size() == 1000u);
+    REQUIRE(table.contains(999 << 10));
+
+    HashMap<std::string, int> counts;
+    for (const auto& word : {"this", "not", "this", "bye", "not", "this"}) {
+        ++counts[word];
+    }
+    REQUIRE(counts.find("this")->value == 3);
+
+    HashMap<std::pair<int, int>, Point> grid;
+    grid.insert({1, 2}, {3, 4});
+    REQUIRE(grid.find({1, 2})->value.y == 4);
+}
@@ -0,0 +1,131 @@
+#include "DenseHashMap.h"
+#include "catch.hpp"
+
+struct TraitsForInt {
+    static unsigned hash(const int& a) { return std::hash<int>{}(a); }
+    static bool equals(const int& a, const int& b) { return a == b; }
+};
+
+struct TraitsForString {
+    static unsigned hash(const std::string& val) {
+        return std::hash<std::string>{}(val);
+    }
+    static bool equals(const std::string& a, const std::string& b) {
+        return a == b;
+    }
+};
+
+using hashfu::HashTableResult;
+using hashfu::DenseHashMap;
+
+using IntTable = DenseHashMap<int, std::string, TraitsForInt>;
+using StringTable = DenseHashMap<std::string, int, TraitsForString>;
+
+TEST_CASE("Construct") {
+    REQUIRE(IntTable().empty());
+    REQUIRE(IntTable().size() == 0u);
+}
+
+TEST_CASE("Insert, find and remove") {
+    IntTable num_to_string;
+    REQUIRE(num_to_string.insert(1, "one") ==
+            HashTableResult::InsertedNewEntry);
+    REQUIRE(num_to_string.insert(2, "two") ==
+            HashTableResult::InsertedNewEntry);
+    REQUIRE(num_to_string.insert(2, "deux") ==
+            HashTableResult::ReplacedExistingEntry);
+    REQUIRE(num_to_string.size() == 2u);
+
+    REQUIRE(num_to_string.find(2)->value == "deux");
+    REQUIRE(num_to_string.contains(1));
+    REQUIRE_FALSE(num_to_string.contains(3));
+
+    REQUIRE(num_to_string.remove(1));
+    REQUIRE_FALSE(num_to_string.remove(1));
+    REQUIRE(num_to_string.size() == 1u);
+    REQUIRE(num_to_string.find(1) == num_to_string.end());
+}
+
+TEST_CASE("Iterates in insertion order") {
+    IntTable num_to_string;
+    for (int i = 0; i < 1000; ++i) {
+        num_to_string.insert(i * 7, std::to_string(i));
+    }
+
+    int expected = 0;
+    for (const auto& entry : num_to_string) {
+        REQUIRE(entry.key == expected * 7);
+        ++expected;
+    }
+    REQUIRE(expected == 1000);
+    REQUIRE(num_to_string.data()[10].key == 70);
+}
+
+TEST_CASE("Remove moves the last entry into the hole") {
+    IntTable num_to_string;
+    for (int i = 0; i < 100; ++i) {
+        num_to_string.insert(i, std::to_string(i));
+    }
+
+    REQUIRE(num_to_string.remove(10));
+    REQUIRE(num_to_string.data()[10].key == 99);
+    REQUIRE(num_to_string.find(99) - num_to_string.begin() == 10);
+
+    for (int i = 0; i < 100; i += 3) num_to_string.remove(i);
+    for (int i = 0; i < 100; ++i) {
+        bool removed = i % 3 == 0 || i == 10;
+        REQUIRE(num_to_string.contains(i) != removed);
+        if (!removed) {
+            REQUIRE(num_to_string.find(i)->value == std::to_string(i));
+        }
+    }
+
+    // the last entry removes without moving anything
+    auto last = (num_to_string.end() - 1)->key;
+    REQUIRE(num_to_string.remove(last));
+    REQUIRE_FALSE(num_to_string.contains(last));
+}
+
+TEST_CASE("Fuck ton of strings") {
+    StringTable strings;
+    for (int i = 0; i < 999; ++i) {
+        REQUIRE(strings.insert(std::to_string(i), i) ==
+                HashTableResult::InsertedNewEntry);
+    }
+
+    int count = 0;
+    for (const auto& entry : strings) {
+        REQUIRE(std::stoi(entry.key) == entry.value);
+        ++count;
+    }
+    REQUIRE(count == 999);
+
+    for (int i = 0; i < 999; i += 2) {
+        REQUIRE(strings.remove(std::to_string(i)));
+    }
+    for (int i = 0; i < 999; i += 2) {
+        strings.insert(std::to_string(i), -i);
+    }
+    REQUIRE(strings.size() == 999u);
+    REQUIRE(strings.find("42")->value == -42);
+}
+
+TEST_CASE("Copy and move") {
+    StringTable counts;
+    for (const auto& word : {"this", "not", "this", "bye", "not", "this"}) {
+        ++counts[word];
+    }
+
+    StringTable copy = counts;
+    ++copy["this"];
+    REQUIRE(counts.find("this")->value == 3);
+    REQUIRE(copy.find("this")->value == 4);
+
+    StringTable moved = std::move(copy);
+    REQUIRE(moved.size() == 3u);
+    REQUIRE(moved.find("not")->value == 2);
+
+    moved.clear();
+    REQUIRE(moved.empty());
+    REQUIRE(moved.begin() == moved.end());
+}
@@ -0,0 +1,247 @@
+#include <string>
+#include <vector>
+
+#include "CuckooHashTable.h"
+#include "HopscotchHashTable.h"
+#include "catch.hpp"
+#include "test_traits.h"
+
+// The API every table built on DisplacingTable has, tested once for each.
+// Tests of how each places its entries stay in its own file.
+
+using hashfu::HashTableResult;
+
+struct Cuckoo {
+    template <typename T, typename Traits = hashfu::DefaultTraits<T>>
+    using Table = hashfu::CuckooHashTable<T, Traits>;
+};
+
+struct Hopscotch {
+    template <typename T, typename Traits = hashfu::DefaultTraits<T>>
+    using Table = hashfu::HopscotchHashTable<T, Traits>;
+};
+
+struct WideHopscotch {
+    template <typename T, typename Traits = hashfu::DefaultTraits<T>>
+    using Table = hashfu::HopscotchHashTable<T, Traits, 64>;
+};
+
+#define DISPLACING_TABLES Cuckoo, Hopscotch, WideHopscotch
+
+template <typename Family>
+using StringTable =
+    typename Family::template Table<std::string, TraitsForString>;
+template <typename Family>
+using IntTable = typename Family::template Table<std::uint64_t>;
+
+TEMPLATE_TEST_CASE("Construct", "", DISPLACING_TABLES) {
+    using Table = StringTable<TestType>;
+    REQUIRE(Table().empty());
+    REQUIRE(Table().size() == 0u);
+    REQUIRE(Table().begin() == Table().end());
+
+    Table strings{"a", "b", "c"};
+    REQUIRE(strings.size() == 3u);
+    REQUIRE(strings.contains("b"));
+}
+
+TEMPLATE_TEST_CASE("Insert, find and remove", "", DISPLACING_TABLES) {
+    StringTable<TestType> strings;
+    REQUIRE(strings.insert("foo") == HashTableResult::InsertedNewEntry);
+    REQUIRE(strings.insert("bar") == HashTableResult::InsertedNewEntry);
+    REQUIRE(strings.insert("foo") == HashTableResult::ReplacedExistingEntry);
+    REQUIRE(strings.size() == 2u);
+
+    REQUIRE(*strings.find("bar") == "bar");
+    REQUIRE(strings.find("baz") == strings.end());
+
+    REQUIRE(strings.remove("foo"));
+    REQUIRE_FALSE(strings.remove("foo"));
+    REQUIRE(strings.size() == 1u);
+    REQUIRE_FALSE(strings.contains("foo"));
+    REQUIRE(strings.contains("bar"));
+}
+
+TEMPLATE_TEST_CASE("Fuck ton of strings", "", DISPLACING_TABLES) {
+    StringTable<TestType> strings;
+    for (int i = 0; i < 10000; ++i) {
+        REQUIRE(strings.insert(std::to_string(i)) ==
+                HashTableResult::InsertedNewEntry);
+    }
+    REQUIRE(strings.size() == 10000u);
+
+    std::size_t seen = 0;
+    for (const auto& s : strings) {
+        REQUIRE(std::stoi(s) < 10000);
+        ++seen;
+    }
+    REQUIRE(seen == 10000u);
+
+    for (int i = 0; i < 10000; ++i) {
+        REQUIRE(strings.remove(std::to_string(i)));
+    }
+    REQUIRE(strings.empty());
+    REQUIRE(strings.begin() == strings.end());
+}
+
+TEMPLATE_TEST_CASE("High load", "", DISPLACING_TABLES) {
+    // reserve() sizes the table for its maximum load factor, and every
+    // insert up to that must fit without growing
+    using Table = IntTable<TestType>;
+    Table table;
+    table.reserve(100000);
+    auto capacity = table.capacity();
+    auto fits = capacity * Table::load_factor_percent / 100;
+    REQUIRE(fits >= 100000u);
+
+    for (std::uint64_t i = 0; i < fits; ++i) table.insert(i * 977);
+    REQUIRE(table.capacity() == capacity);
+    REQUIRE(table.load_factor() * 100 > Table::load_factor_percent - 1);
+
+    for (std::uint64_t i = 0; i < fits; ++i) REQUIRE(table.contains(i * 977));
+    REQUIRE_FALSE(table.contains(1));
+}
+
+TEMPLATE_TEST_CASE("Collisions", "", DISPLACING_TABLES) {
+    // every key hashes the same, so all but the few the buckets around
+    // that hash take end up in the overflow list, and the table stays far
+    // smaller than 1000 entries would make it
+    struct StringCollisionTraits {
+        static unsigned hash(const std::string&) { return 0; }
+        static bool equals(const std::string& a, const std::string& b) {
+            return a == b;
+        }
+    };
+
+    typename TestType::template Table<std::string, StringCollisionTraits>
+        strings;
+    for (int i = 0; i < 999; ++i) {
+        REQUIRE(strings.insert(std::to_string(i)) ==
+                HashTableResult::InsertedNewEntry);
+    }
+    REQUIRE(strings.insert("foo") == HashTableResult::InsertedNewEntry);
+    REQUIRE(strings.size() == 1000u);
+    REQUIRE(strings.capacity() <= 256u);
+
+    for (int i = 999 - 1; i >= 0; --i) {
+        REQUIRE(strings.remove(std::to_string(i)));
+    }
+
+    REQUIRE(strings.size() == 1);
+    REQUIRE(strings.find("foo") != strings.end());
+    REQUIRE(*strings.begin() == "foo");
+}
+
+TEMPLATE_TEST_CASE("Colliding keys reseed the table", "", DISPLACING_TABLES) {
+    typename TestType::template Table<std::uint64_t, LeakedSeedTraits> table;
+    table.reserve(2000);
+    LeakedSeedTraits::leaked_seed = table.seed();
+
+    for (std::uint64_t i = 0; i < 2000; ++i) table.insert(i);
+
+    REQUIRE(table.seed() != LeakedSeedTraits::leaked_seed);
+    REQUIRE(table.size() == 2000u);
+    for (std::uint64_t i = 0; i < 2000; ++i) REQUIRE(table.contains(i));
+    REQUIRE_FALSE(table.contains(2000));
+}
+
+TEMPLATE_TEST_CASE("Batch inserts that reseed the table", "",
+                   DISPLACING_TABLES) {
+    typename TestType::template Table<std::uint64_t, LeakedSeedTraits> table;
+    LeakedSeedTraits::leaked_seed = table.seed();
+
+    // the reseed lands in the middle of a group, whose remaining keys have
+    // to be hashed again with the new seed
+    std::vector<std::uint64_t> keys;
+    for (std::uint64_t i = 0; i < 300; ++i) keys.push_back(i);
+    std::vector<HashTableResult> results(keys.size());
+    table.insert_batch(keys.data(), keys.size(), results.data());
+
+    REQUIRE(table.seed() != LeakedSeedTraits::leaked_seed);
+    REQUIRE(table.size() == 300u);
+    for (auto key : keys) REQUIRE(table.contains(key));
+
+    table.insert_batch(keys.data(), keys.size(), results.data());
+    REQUIRE(table.size() == 300u);
+    for (auto result : results) {
+        REQUIRE(result == HashTableResult::ReplacedExistingEntry);
+    }
+}
+
+TEMPLATE_TEST_CASE("Collisions no seed breaks up", "", DISPLACING_TABLES) {
+    // takes a seed but ignores it, so reseeding can't help
+    struct SeedBlindTraits {
+        static unsigned hash(const std::uint64_t&) { return 0; }
+        static unsigned hash(const std::uint64_t&, std::uint64_t) {
+            return 0;
+        }
+        static bool equals(const std::uint64_t& a, const std::uint64_t& b) {
+            return a == b;
+        }
+    };
+
+    typename TestType::template Table<std::uint64_t, SeedBlindTraits> table;
+    table.reserve(1000);
+    auto capacity = table.capacity();
+
+    // one reseed to find out, then the overflow list instead of a rehash
+    // per insert
+    std::size_t reseeds = 0;
+    for (std::uint64_t i = 0; i < 1000; ++i) {
+        auto seed = table.seed();
+        table.insert(i);
+        reseeds += table.seed() != seed;
+    }
+    REQUIRE(table.capacity() == capacity);
+    REQUIRE(reseeds == 1u);
+    for (std::uint64_t i = 0; i < 1000; ++i) REQUIRE(table.contains(i));
+}
+
+TEMPLATE_TEST_CASE("Batch lookup", "", DISPLACING_TABLES) {
+    using Table = IntTable<TestType>;
+    Table table;
+    std::vector<std::uint64_t> keys;
+    for (std::uint64_t i = 0; i < 100; ++i) keys.push_back(i * 2);
+
+    std::vector<HashTableResult> results(keys.size());
+    table.insert_batch(keys.data(), keys.size(), results.data());
+    REQUIRE(table.size() == 100u);
+
+    for (auto& key : keys) key += 100;
+    std::vector<typename Table::Iterator> found(keys.size());
+    table.find_batch(keys.data(), keys.size(), found.data());
+
+    bool present[100];
+    table.contains_batch(keys.data(), keys.size(), present);
+
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        REQUIRE(found[i] == table.find(keys[i]));
+        REQUIRE(present[i] == (i < 50));
+    }
+}
+
+TEMPLATE_TEST_CASE("Copy and move", "", DISPLACING_TABLES) {
+    using Table = StringTable<TestType>;
+    Table strings;
+    for (int i = 0; i < 100; ++i) strings.insert(std::to_string(i));
+
+    Table copy(strings);
+    REQUIRE(copy.size() == 100u);
+    REQUIRE(copy.contains("42"));
+
+    Table moved(std::move(copy));
+    REQUIRE(moved.size() == 100u);
+    REQUIRE(moved.contains("99"));
+
+    Table assigned;
+    assigned = moved;
+    REQUIRE(assigned.size() == 100u);
+    assigned = {"x"};
+    REQUIRE(assigned.size() == 1u);
+    REQUIRE(assigned.contains("x"));
+
+    moved.clear();
+    REQUIRE(moved.empty());
+    REQUIRE_FALSE(moved.contains("42"));
+    REQUIRE(strings.contains("42"));
+}
@@ -0,0 +1,172 @@
+#include <cstdio>
+#include <filesystem>
+#include <sstream>
+
+#include "FrozenHashMap.h"
+#include "catch.hpp"
+
+struct TraitsForInt {
+    static unsigned hash(const int& val) { return std::hash<int>{}(val); }
+    static bool equals(const int& a, const int& b) { return a == b; }
+};
+
+struct TraitsForString {
+    static unsigned hash(const std::string& val) {
+        return std::hash<std::string_view>{}(val);
+    }
+    static bool equals(const std::string& a, const std::string& b) {
+        return a == b;
+    }
+    // lets FrozenHashMap compare against the image without copying the key
+    static bool equals(const std::string& a, std::string_view b) {
+        return a == b;
+    }
+};
+
+using hashfu::FrozenHashMap;
+using hashfu::HashMap;
+
+// images handed to attach() have to be 8-byte aligned
+static std::vector<std::uint64_t> aligned_copy(const std::string& image) {
+    std::vector<std::uint64_t> buffer(image.size() / 8 + 1);
+    std::memcpy(buffer.data(), image.data(), image.size());
+    return buffer;
+}
+
+TEST_CASE("Empty map") {
+    HashMap<int, int, TraitsForInt> map;
+    std::stringstream image;
+    REQUIRE(FrozenHashMap<int, int, TraitsForInt>::build(map, image));
+
+    auto buffer = aligned_copy(image.str());
+    FrozenHashMap<int, int, TraitsForInt> frozen;
+    REQUIRE(frozen.attach(buffer.data(), image.str().size()));
+    REQUIRE(frozen.empty());
+    REQUIRE_FALSE(frozen.contains(1));
+}
+
+TEST_CASE("Trivially copyable keys and values") {
+    HashMap<int, double, TraitsForInt> map;
+    for (int i = 0; i < 1000; ++i) {
+        map.insert(i, i / 2.0);
+    }
+
+    std::stringstream image;
+    REQUIRE(FrozenHashMap<int, double, TraitsForInt>::build(map, image));
+
+    auto buffer = aligned_copy(image.str());
+    FrozenHashMap<int, double, TraitsForInt> frozen;
+    REQUIRE(frozen.attach(buffer.data(), image.str().size()));
+    REQUIRE(frozen.size() == 1000u);
+
+    for (int i = 0; i < 1000; ++i) {
+        REQUIRE(*frozen.find(i) == i / 2.0);
+    }
+    REQUIRE_FALSE(frozen.find(1000));
+    REQUIRE_FALSE(frozen.contains(-1));
+
+    // a truncated image is rejected
+    REQUIRE_FALSE(frozen.attach(buffer.data(), image.str().size() / 2));
+    REQUIRE(frozen.empty());
+}
+
+TEST_CASE("String keys from a mapped file") {
+    HashMap<std::string, std::string, TraitsForString> map;
+    for (int i = 0; i < 500; ++i) {
+        map.insert("key " + std::to_string(i), std::string(i % 50, 'x'));
+    }
+
+    auto path = std::filesystem::temp_directory_path() / "hashfu_frozen_test";
+    using Frozen = FrozenHashMap<std::string, std::string, TraitsForString>;
+    REQUIRE(Frozen::build(map, path.c_str()));
+
+    Frozen frozen;
+    REQUIRE(frozen.open(path.c_str()));
+    std::filesystem::remove(path);
+
+    REQUIRE(frozen.size() == 500u);
+    for (int i = 0; i < 500; ++i) {
+        auto value = frozen.find("key " + std::to_string(i));
+        REQUIRE(value);
+        REQUIRE(*value == std::string(i % 50, 'x'));
+    }
+    REQUIRE_FALSE(frozen.contains("key 500"));
+
+    // the mapping moves along with the map
+    Frozen moved = std::move(frozen);
+    REQUIRE(frozen.empty());
+    REQUIRE(moved.contains("key 42"));
+}
+
+TEST_CASE("Image built with a different hash") {
+    struct OtherTraits {
+        static unsigned hash(const int& val) { return val * 7u + 1; }
+        static bool equals(const int& a, const int& b) { return a == b; }
+    };
+
+    HashMap<int, int, OtherTraits> map;
+    map.insert(1, 2);
+
+    std::stringstream image;
+    REQUIRE(FrozenHashMap<int, int, OtherTraits>::build(map, image));
+
+    auto buffer = aligned_copy(image.str());
+    FrozenHashMap<int, int, TraitsForInt> frozen;
+    REQUIRE_FALSE(frozen.attach(buffer.data(), image.str().size()));
+}
+
+TEST_CASE("Corrupt images") {
+    HashMap<std::string, int, TraitsForString> map;
+    for (int i = 0; i < 100; ++i) map.insert(std::to_string(i), i);
+
+    std::stringstream stream;
+    using Frozen = FrozenHashMap<std::string, int, TraitsForString>;
+    REQUIRE(Frozen::build(map, stream));
+    const auto image = stream.str();
+
+    // Header is 40 bytes, each Slot 32: key and value offsets, key and
+    // value sizes, hash, used
+    constexpr std::size_t header_size = 40, slot_size = 32;
+    std::uint64_t capacity;
+    std::memcpy(&capacity, image.data() + 16, sizeof(capacity));
+
+    auto corrupt = [&](auto&& edit) {
+        auto copy = image;
+        for (std::size_t i = 0; i < capacity; ++i) {
+            auto* slot = copy.data() + header_size + i * slot_size;
+            std::uint32_t used;
+            std::memcpy(&used, slot + 28, sizeof(used));
+            edit(slot, used != 0);
+        }
+
+        auto buffer = aligned_copy(copy);
+        Frozen frozen;
+        return frozen.attach(buffer.data(), copy.size());
+    };
+    auto poke = [](char* at, auto value) {
+        std::memcpy(at, &value, sizeof(value));
+    };
+
+    REQUIRE(corrupt([](char*, bool) {}));
+    // a value past the end of the blob
+    REQUIRE_FALSE(corrupt([&](char* slot, bool used) {
+        if (used) poke(slot + 8, std::uint64_t{1} << 40);
+    }));
+    // a key running past it
+    REQUIRE_FALSE(corrupt([&](char* slot, bool used) {
+        if (used) poke(slot + 16, std::uint32_t{0xffffffff});
+    }));
+    // an int value of the wrong size
+    REQUIRE_FALSE(corrupt([&](char* slot, bool used) {
+        if (used) poke(slot + 20, std::uint32_t{2});
+    }));
+    // no empty slot to end a probe
+    REQUIRE_FALSE(corrupt([&](char* slot, bool) {
+        poke(slot + 28, std::uint32_t{1});
+    }));
+}
+
+TEST_CASE("Missing file") {
+    FrozenHashMap<int, int, TraitsForInt> frozen;
+    REQUIRE_FALSE(frozen.open("/nonexistent/hashfu_frozen_test"));
+}
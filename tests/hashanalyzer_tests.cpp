@@ -0,0 +1,98 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "HashAnalyzer.h"
+#include "catch.hpp"
+
+using hashfu::analyze_hash;
+using hashfu::DefaultTraits;
+
+struct IdentityTraits {
+    static unsigned hash(const std::uint64_t& key) {
+        return static_cast<unsigned>(key);
+    }
+    static bool equals(const std::uint64_t& a, const std::uint64_t& b) {
+        return a == b;
+    }
+};
+
+// keeps only the low byte, like a hash that ignores most of its input
+struct LowByteTraits {
+    static unsigned hash(const std::string& key) {
+        return key.empty() ? 0u : static_cast<unsigned char>(key.back());
+    }
+    static bool equals(const std::string& a, const std::string& b) {
+        return a == b;
+    }
+};
+
+static std::vector<std::uint64_t> sequential(std::size_t n) {
+    std::vector<std::uint64_t> keys(n);
+    for (std::size_t i = 0; i < n; ++i) keys[i] = i;
+    return keys;
+}
+
+TEST_CASE("A good hash passes") {
+    auto report = analyze_hash<DefaultTraits<std::uint64_t>>(sequential(20000));
+    REQUIRE(report.keys == 20000u);
+    REQUIRE(report.buckets == 20000u * 100 / 60 + 1);
+    REQUIRE(report.ok());
+
+    // close to what uniform hashing predicts
+    REQUIRE(report.probe_hit ==
+            Approx(report.expected_probe_hit).epsilon(0.1));
+    REQUIRE(report.probe_miss ==
+            Approx(report.expected_probe_miss).epsilon(0.15));
+    REQUIRE(report.mean_run == Approx(report.expected_mean_run).epsilon(0.1));
+    REQUIRE(report.avalanche_tested);
+    REQUIRE(report.avalanche_mean == Approx(0.5).epsilon(0.02));
+
+    std::vector<std::string> words;
+    for (int i = 0; i < 20000; ++i) words.push_back("w" + std::to_string(i));
+    REQUIRE(analyze_hash<DefaultTraits<std::string>>(words, 7).ok());
+}
+
+TEST_CASE("Sequential keys under an identity hash form one long run") {
+    auto report = analyze_hash<IdentityTraits>(sequential(20000));
+
+    // every bucket gets at most one key, which chi-square can't fault...
+    REQUIRE(report.distribution_ok());
+    // ...but they all sit side by side, so misses walk the whole run
+    REQUIRE(report.longest_run == 20000u);
+    REQUIRE_FALSE(report.probing_ok());
+    REQUIRE_FALSE(report.avalanche_ok());
+    REQUIRE_FALSE(report.ok());
+}
+
+TEST_CASE("A hash using a few input bits fails everything") {
+    std::vector<std::string> words;
+    for (int i = 0; i < 5000; ++i) words.push_back("w" + std::to_string(i));
+
+    auto report = analyze_hash<LowByteTraits>(words);
+    REQUIRE_FALSE(report.collisions_ok());
+    REQUIRE_FALSE(report.distribution_ok());
+    REQUIRE_FALSE(report.probing_ok());
+    REQUIRE_FALSE(report.avalanche_ok());
+}
+
+TEST_CASE("Keys without a byte representation skip the avalanche test") {
+    struct Key {
+        std::string name;
+        bool operator==(const Key& other) const { return name == other.name; }
+    };
+    struct KeyTraits {
+        static unsigned hash(const Key& key) {
+            return DefaultTraits<std::string>::hash(key.name);
+        }
+        static bool equals(const Key& a, const Key& b) { return a == b; }
+    };
+
+    std::vector<Key> keys;
+    for (int i = 0; i < 1000; ++i) keys.push_back({std::to_string(i)});
+    auto report = analyze_hash<KeyTraits>(keys);
+    REQUIRE_FALSE(report.avalanche_tested);
+    REQUIRE(report.ok());
+
+    REQUIRE(analyze_hash<KeyTraits>(std::vector<Key>()).keys == 0u);
+}
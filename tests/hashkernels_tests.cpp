@@ -0,0 +1,100 @@
+#include <array>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "HashKernels.h"
+#include "HashMap.h"
+#include "catch.hpp"
+
+using hashfu::AcceleratedTraits;
+using hashfu::HashKernel;
+using hashfu::HashMap;
+
+static std::vector<HashKernel> supported_kernels() {
+    std::vector<HashKernel> kernels;
+    for (auto kernel : {HashKernel::Scalar, HashKernel::Crc32c,
+                        HashKernel::Aes, HashKernel::Avx2}) {
+        if (hashfu::hash_kernel_supported(kernel)) kernels.push_back(kernel);
+    }
+    return kernels;
+}
+
+TEST_CASE("Scalar kernel is always there") {
+    REQUIRE(hashfu::hash_kernel_supported(HashKernel::Scalar));
+    REQUIRE(hashfu::hash_kernel_supported(hashfu::selected_hash_kernel()));
+
+    const char bytes[] = "hello";
+    REQUIRE(hashfu::hash_bytes_with(HashKernel::Scalar, bytes, 5) ==
+            hashfu::detail::hash_bytes(bytes, 5));
+}
+
+TEST_CASE("Kernels hash every length and byte") {
+    // each length sits at the end of its own allocation, so reading past
+    // the key is caught by the sanitizers
+    std::string data(4096 + 64, '\0');
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<char>(i * 131 + 7);
+    }
+
+    for (auto kernel : supported_kernels()) {
+        std::set<std::uint64_t> hashes;
+        for (std::size_t len = 0; len <= 300; ++len) {
+            std::vector<char> key(data.begin(), data.begin() + len);
+            auto h = hashfu::hash_bytes_with(kernel, key.data(), len);
+            REQUIRE(h == hashfu::hash_bytes_with(kernel, key.data(), len));
+            hashes.insert(h);
+
+            // flipping any single byte changes the hash
+            for (std::size_t i = 0; i < len; i += 7) {
+                key[i] ^= 1;
+                REQUIRE(hashfu::hash_bytes_with(kernel, key.data(), len) != h);
+                key[i] ^= 1;
+            }
+        }
+        REQUIRE(hashes.size() == 301u);
+
+        // the seed matters too
+        REQUIRE(hashfu::hash_bytes_with(kernel, data.data(), 100, 1) !=
+                hashfu::hash_bytes_with(kernel, data.data(), 100, 2));
+    }
+}
+
+TEST_CASE("Kernels mix well") {
+    for (auto kernel : supported_kernels()) {
+        for (std::size_t len : {8u, 16u, 33u, 64u, 200u}) {
+            std::vector<unsigned char> key(len, 0x5a);
+            auto base = hashfu::hash_bytes_with(kernel, key.data(), len);
+
+            int total = 0, flips = 0;
+            for (std::size_t bit = 0; bit < len * 8; bit += 3, ++flips) {
+                key[bit / 8] ^= 1u << (bit % 8);
+                auto h = hashfu::hash_bytes_with(kernel, key.data(), len);
+                total += __builtin_popcountll(h ^ base);
+                key[bit / 8] ^= 1u << (bit % 8);
+            }
+            // 32 of 64 bits on average
+            REQUIRE(total > flips * 24);
+            REQUIRE(total < flips * 40);
+        }
+    }
+}
+
+TEST_CASE("AcceleratedTraits") {
+    using StringTraits = AcceleratedTraits<std::string>;
+    REQUIRE(StringTraits::hash("hello") ==
+            AcceleratedTraits<std::string_view>::hash("hello"));
+    REQUIRE(StringTraits::hash("hello") != StringTraits::hash("hellp"));
+
+    using Key = std::array<unsigned char, 16>;
+    Key a{}, b{};
+    b[15] = 1;
+    REQUIRE(AcceleratedTraits<Key>::hash(a) != AcceleratedTraits<Key>::hash(b));
+    REQUIRE_FALSE(AcceleratedTraits<Key>::equals(a, b));
+
+    HashMap<std::string, int, StringTraits> counts;
+    for (int i = 0; i < 1000; ++i) counts.insert(std::to_string(i), i);
+    for (int i = 0; i < 1000; ++i) {
+        REQUIRE(counts.find(std::to_string(i))->value == i);
+    }
+}
@@ -1,4 +1,8 @@
+#include <sstream>
+
+#include "CuckooHashTable.h"
 #include "HashMap.h"
+#include "HopscotchHashTable.h"
 #include "catch.hpp"
 
 struct TraitsForInt {
@@ -160,3 +164,217 @@ TEST_CASE("Array subscript") {
     REQUIRE(counts.find("not")->value == 2);
     REQUIRE(counts.find("bye")->value == 1);
 }
+
+TEST_CASE("Batch lookup") {
+    IntTable num_to_string;
+    for (int i = 0; i < 100; ++i) {
+        num_to_string.insert(i, std::to_string(i));
+    }
+
+    std::vector<int> keys;
+    for (int i = 50; i < 150; ++i) {
+        keys.push_back(i);
+    }
+
+    std::vector<IntTable::ConstIterator> found(keys.size());
+    const auto& map = num_to_string;
+    map.find_batch(keys.data(), keys.size(), found.data());
+
+    bool present[100];
+    map.contains_batch(keys.data(), keys.size(), present);
+
+    for (size_t i = 0; i < keys.size(); ++i) {
+        REQUIRE(present[i] == (keys[i] < 100));
+        if (keys[i] < 100) {
+            REQUIRE(found[i]->value == std::to_string(keys[i]));
+        } else {
+            REQUIRE(found[i] == map.end());
+        }
+    }
+}
+
+TEST_CASE("Batch insert and upsert") {
+    StringTable counts;
+
+    const std::string words[] = {"this", "not", "this", "bye", "not", "this"};
+    const int ones[] = {1, 1, 1, 1, 1, 1};
+    HashTableResult results[6];
+
+    counts.insert_batch(words, ones, 6, results);
+    REQUIRE(counts.size() == 3u);
+    REQUIRE(results[0] == HashTableResult::InsertedNewEntry);
+    REQUIRE(results[2] == HashTableResult::ReplacedExistingEntry);
+    REQUIRE(counts.find("this")->value == 1);
+
+    counts.upsert_batch(
+        words, ones, 6, [](int& count, int one) { count += one; }, results);
+    REQUIRE(counts.size() == 3u);
+    REQUIRE(counts.find("this")->value == 4);
+    REQUIRE(counts.find("not")->value == 3);
+    REQUIRE(counts.find("bye")->value == 2);
+    for (auto result : results) {
+        REQUIRE(result == HashTableResult::ReplacedExistingEntry);
+    }
+
+    const std::string more[] = {"new", "new"};
+    counts.upsert_batch(
+        more, ones, 2, [](int& count, int one) { count += one; }, results);
+    REQUIRE(results[0] == HashTableResult::InsertedNewEntry);
+    REQUIRE(results[1] == HashTableResult::ReplacedExistingEntry);
+    REQUIRE(counts.find("new")->value == 2);
+
+    // a combiner may return the new value instead
+    counts.upsert_batch(
+        more, ones, 2, [](int count, int one) { return count + one; },
+        results);
+    REQUIRE(counts.find("new")->value == 4);
+}
+
+// TraitsForInt, with the batched hook counting its calls
+struct BatchTraitsForInt : TraitsForInt {
+    static inline int batches = 0;
+
+    static void hash_batch(const int* keys, std::size_t n, unsigned* out) {
+        ++batches;
+        for (std::size_t i = 0; i < n; ++i) out[i] = hash(keys[i]);
+    }
+};
+
+TEST_CASE("Batch hashing hook") {
+    HashMap<int, int, BatchTraitsForInt> squares;
+    BatchTraitsForInt::batches = 0;
+
+    // plain inserts, so only rehashing can reach hash_batch()
+    for (int i = 0; i < 1000; ++i) squares.insert(i, i * i);
+    REQUIRE(BatchTraitsForInt::batches > 0);
+
+    int keys[100];
+    for (int i = 0; i < 100; ++i) keys[i] = i * 20;
+    bool present[100];
+    squares.contains_batch(keys, 100, present);
+    for (int i = 0; i < 100; ++i) {
+        REQUIRE(present[i] == (i < 50));
+        if (present[i]) {
+            REQUIRE(squares.find(keys[i])->value == keys[i] * keys[i]);
+        }
+    }
+}
+
+TEST_CASE("Precomputed hash") {
+    StringTable first;
+    StringTable second;
+
+    const std::string key = "a rather long key that we only want to hash once";
+    auto hash = StringTable::hash_key(key);
+    REQUIRE(StringTable().seed() == 0u);
+    REQUIRE(hash == TraitsForString::hash(key));
+
+    REQUIRE(first.insert_with_hash(key, hash, 1) ==
+            HashTableResult::InsertedNewEntry);
+    REQUIRE(second.insert_with_hash(key, hash, 2) ==
+            HashTableResult::InsertedNewEntry);
+    REQUIRE(first.insert_with_hash(key, hash, 3) ==
+            HashTableResult::ReplacedExistingEntry);
+
+    REQUIRE(first.find(key, hash)->value == 3);
+    REQUIRE(second.find(key, hash)->value == 2);
+    REQUIRE(first.find(key, hash) == first.find(key));
+
+    ++first.find_or_insert(key, hash);
+    REQUIRE(first[key] == 4);
+
+    const std::string other = "other";
+    REQUIRE(first.find(other, StringTable::hash_key(other)) == first.end());
+    REQUIRE(first.find_or_insert(other, StringTable::hash_key(other)) == 0);
+    REQUIRE(first.size() == 2u);
+
+    REQUIRE(second.remove_with_hash(key, hash));
+    REQUIRE_FALSE(second.remove_with_hash(key, hash));
+    REQUIRE(second.empty());
+}
+
+TEST_CASE("Seeded keys") {
+    using Map = HashMap<std::string, int>;
+    Map first, second;
+
+    const std::string key = "attacker controlled";
+    // each map has a seed of its own
+    REQUIRE(first.seed() != second.seed());
+    REQUIRE(first.hash_key(key) == first.hash_key(key));
+    REQUIRE(first.hash_key(key) != second.hash_key(key));
+    REQUIRE(first.hash_key(key) ==
+            hashfu::DefaultTraits<std::string>::hash(key, first.seed()));
+
+    ++first.find_or_insert(key, first.hash_key(key));
+    second.insert_with_hash(key, second.hash_key(key), 7);
+    REQUIRE(first[key] == 1);
+    REQUIRE(second.find(key, second.hash_key(key))->value == 7);
+
+    std::vector<std::string> keys;
+    for (int i = 0; i < 1000; ++i) keys.push_back(std::to_string(i));
+    bool present[1000];
+    first.contains_batch(keys.data(), keys.size(), present);
+    for (int i = 0; i < 1000; ++i) REQUIRE_FALSE(present[i]);
+}
+
+TEST_CASE("Snapshot") {
+    HashMap<int, double, TraitsForInt> squares;
+    for (int i = 0; i < 100; ++i) {
+        squares.insert(i, i * i);
+    }
+
+    std::stringstream stream;
+    REQUIRE(squares.save(stream));
+
+    HashMap<int, double, TraitsForInt> loaded;
+    REQUIRE(loaded.load(stream));
+    REQUIRE(loaded.size() == 100u);
+    for (int i = 0; i < 100; ++i) {
+        REQUIRE(loaded.find(i)->value == i * i);
+    }
+
+    struct Serializer {
+        static void write(std::ostream& os, int value) { os << value << ' '; }
+        static void write(std::ostream& os, const std::string& value) {
+            os << value << ' ';
+        }
+        static void read(std::istream& is, int& value) { is >> value; }
+        static void read(std::istream& is, std::string& value) { is >> value; }
+    };
+
+    IntTable names;
+    names.insert(1, "one");
+    names.insert(2, "two");
+
+    std::stringstream names_stream;
+    REQUIRE(names.save<Serializer>(names_stream));
+
+    IntTable loaded_names;
+    REQUIRE(loaded_names.load<Serializer>(names_stream));
+    REQUIRE(loaded_names.size() == 2u);
+    REQUIRE(loaded_names.find(1)->value == "one");
+    REQUIRE(loaded_names.find(2)->value == "two");
+}
+
+template <template <typename...> class Table>
+void check_table_backed_map() {
+    HashMap<int, std::string, TraitsForInt, Table> map;
+    for (int i = 0; i < 5000; ++i) map.insert(i, std::to_string(i));
+    REQUIRE(map.size() == 5000u);
+
+    for (int i = 0; i < 5000; i += 2) REQUIRE(map.remove(i));
+    map[7] += "!";
+    REQUIRE(map.size() == 2500u);
+    REQUIRE(map.find(7)->value == "7!");
+    REQUIRE_FALSE(map.contains(8));
+
+    std::vector<int> keys{1, 2, 3, 4};
+    bool present[4];
+    map.contains_batch(keys.data(), keys.size(), present);
+    REQUIRE((present[0] && !present[1] && present[2] && !present[3]));
+}
+
+TEST_CASE("Other tables") {
+    check_table_backed_map<hashfu::HopscotchTable>();
+    check_table_backed_map<hashfu::CuckooTable>();
+}
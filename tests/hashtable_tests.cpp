@@ -1,14 +1,11 @@
+#include <cstddef>
+#include <cstring>
+#include <set>
+#include <sstream>
+
 #include "HashTable.h"
 #include "catch.hpp"
-
-struct TraitsForString {
-    static unsigned hash(const std::string& val) {
-        return std::hash<std::string>{}(val);
-    }
-    static bool equals(const std::string& a, const std::string& b) {
-        return a == b;
-    }
-};
+#include "test_traits.h"
 
 using hashfu::HashTable;
 using hashfu::HashTableResult;
@@ -182,3 +179,466 @@ TEST_CASE("Contains") {
     REQUIRE(table.remove(1));
     REQUIRE_FALSE(table.contains(1));
 }
+
+TEST_CASE("Batch lookup") {
+    StringTable strings;
+    for (int i = 0; i < 100; ++i) {
+        strings.insert(std::to_string(i));
+    }
+
+    // every other key is missing, and the batch is not a multiple of the
+    // group size
+    std::vector<std::string> keys;
+    for (int i = 0; i < 150; i += 2) {
+        keys.push_back(std::to_string(i));
+    }
+
+    std::vector<StringTable::Iterator> found(keys.size());
+    strings.find_batch(keys.data(), keys.size(), found.data());
+
+    bool present[75];
+    strings.contains_batch(keys.data(), keys.size(), present);
+
+    for (size_t i = 0; i < keys.size(); ++i) {
+        REQUIRE(found[i] == strings.find(keys[i]));
+        REQUIRE(present[i] == (i < 50));
+    }
+}
+
+TEST_CASE("Batch insert") {
+    std::vector<std::string> values;
+    for (int i = 0; i < 500; ++i) {
+        values.push_back(std::to_string(i % 250));
+    }
+
+    // a table already big enough for the batch doesn't grow during it
+    StringTable reserved{"0", "1"};
+    reserved.reserve(reserved.size() + values.size());
+    auto capacity = reserved.capacity();
+
+    std::vector<HashTableResult> results(values.size());
+    reserved.insert_batch(values.data(), values.size(), results.data());
+    REQUIRE(reserved.capacity() == capacity);
+
+    // and one that isn't grows to the same size up front, once
+    StringTable strings{"0", "1"};
+    strings.insert_batch(values.data(), values.size(), results.data());
+    REQUIRE(strings.capacity() == capacity);
+    REQUIRE(strings.size() == 250u);
+    REQUIRE(strings.load_factor() < 0.6f);
+
+    for (size_t i = 0; i < values.size(); ++i) {
+        auto expected = (i < 2 || i >= 250)
+                            ? HashTableResult::ReplacedExistingEntry
+                            : HashTableResult::InsertedNewEntry;
+        REQUIRE(results[i] == expected);
+        REQUIRE(strings.contains(values[i]));
+        REQUIRE(reserved.contains(values[i]));
+    }
+
+    strings.reserve(200);
+    REQUIRE(strings.capacity() == capacity);
+}
+
+// hashes like DefaultTraits, counting the batched calls
+struct BatchTraits {
+    static inline int batches = 0;
+
+    static unsigned hash(const std::uint64_t& val) {
+        return hashfu::DefaultTraits<std::uint64_t>::hash(val);
+    }
+    static void hash_batch(const std::uint64_t* values, std::size_t n,
+                           unsigned* out) {
+        ++batches;
+        hashfu::DefaultTraits<std::uint64_t>::hash_batch(values, n, out);
+    }
+    static bool equals(const std::uint64_t& a, const std::uint64_t& b) {
+        return a == b;
+    }
+};
+
+TEST_CASE("Batch hashing hook") {
+    HashTable<std::uint64_t, BatchTraits> table;
+    BatchTraits::batches = 0;
+
+    std::vector<std::uint64_t> values(1000);
+    for (std::size_t i = 0; i < values.size(); ++i) values[i] = i * 3;
+
+    std::vector<HashTableResult> results(values.size());
+    table.insert_batch(values.data(), values.size(), results.data());
+    REQUIRE(BatchTraits::batches > 0);
+
+    // growing rehashes with hash_batch() as well
+    auto batches = BatchTraits::batches;
+    table.reserve(10000);
+    REQUIRE(BatchTraits::batches > batches);
+
+    bool present[1000];
+    for (std::size_t i = 0; i < values.size(); ++i) values[i] = i;
+    table.contains_batch(values.data(), values.size(), present);
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        REQUIRE(present[i] == (i % 3 == 0 && i < 3000));
+        REQUIRE(table.contains(values[i]) == present[i]);
+    }
+}
+
+TEST_CASE("Seeded hashing") {
+    HashTable<std::uint64_t, LeakedSeedTraits> a, b;
+    REQUIRE(a.seed() != b.seed());
+    REQUIRE(a.hash_of(42) == LeakedSeedTraits::hash(42, a.seed()));
+
+    // unseeded traits leave the seed alone
+    REQUIRE(HashTable<std::uint64_t>().seed() == 0u);
+}
+
+TEST_CASE("Long probes reseed the table") {
+    HashTable<std::uint64_t, LeakedSeedTraits> table;
+    table.reserve(2000);
+    LeakedSeedTraits::leaked_seed = table.seed();
+
+    for (std::uint64_t i = 0; i < 2000; ++i) table.insert(i);
+
+    REQUIRE(table.seed() != LeakedSeedTraits::leaked_seed);
+    REQUIRE(table.size() == 2000u);
+    for (std::uint64_t i = 0; i < 2000; ++i) {
+        REQUIRE(table.contains(i));
+        REQUIRE(table.find(i) ==
+                table.find(table.hash_of(i), [i](auto v) { return v == i; }));
+    }
+    REQUIRE_FALSE(table.contains(2000));
+}
+
+TEST_CASE("Batch inserts that reseed the table") {
+    HashTable<std::uint64_t, LeakedSeedTraits> table;
+    LeakedSeedTraits::leaked_seed = table.seed();
+
+    // the reseed lands in the middle of a group, whose remaining keys have
+    // to be hashed again with the new seed
+    std::vector<std::uint64_t> keys;
+    for (std::uint64_t i = 0; i < 300; ++i) keys.push_back(i);
+    std::vector<HashTableResult> results(keys.size());
+    table.insert_batch(keys.data(), keys.size(), results.data());
+
+    REQUIRE(table.seed() != LeakedSeedTraits::leaked_seed);
+    REQUIRE(table.size() == 300u);
+    for (auto key : keys) REQUIRE(table.contains(key));
+
+    table.insert_batch(keys.data(), keys.size(), results.data());
+    REQUIRE(table.size() == 300u);
+    for (auto result : results) {
+        REQUIRE(result == HashTableResult::ReplacedExistingEntry);
+    }
+}
+
+TEST_CASE("Collisions no seed breaks up") {
+    // takes a seed but ignores it, so reseeding can't help
+    struct SeedBlindTraits {
+        static unsigned hash(const std::uint64_t&) { return 0; }
+        static unsigned hash(const std::uint64_t&, std::uint64_t) {
+            return 0;
+        }
+        static bool equals(const std::uint64_t& a, const std::uint64_t& b) {
+            return a == b;
+        }
+    };
+
+    HashTable<std::uint64_t, SeedBlindTraits> table;
+    table.reserve(1000);
+    auto capacity = table.capacity();
+
+    // one reseed to find out, then plain probing instead of a rehash per
+    // insert
+    std::size_t reseeds = 0;
+    for (std::uint64_t i = 0; i < 1000; ++i) {
+        auto seed = table.seed();
+        table.insert(i);
+        reseeds += table.seed() != seed;
+    }
+    REQUIRE(table.capacity() == capacity);
+    REQUIRE(reseeds == 1u);
+    for (std::uint64_t i = 0; i < 1000; ++i) REQUIRE(table.contains(i));
+
+    // growing buys another try
+    for (std::uint64_t i = 1000; i < 2000; ++i) {
+        auto seed = table.seed();
+        table.insert(i);
+        reseeds += table.seed() != seed;
+    }
+    REQUIRE(table.capacity() > capacity);
+    REQUIRE(reseeds == 2u);
+}
+
+// Integer traits that pile keys up into long runs, so that probes cross
+// many buckets, tombstones and the end of the table.
+template <typename I>
+struct ClusteringTraits {
+    static constexpr bool bitwise_equals = true;
+
+    static unsigned hash(const I& val) {
+        return static_cast<unsigned>(val) / 16 * 7 + 6;
+    }
+    static bool equals(const I& a, const I& b) { return a == b; }
+};
+
+template <typename I>
+void check_integer_probes() {
+    HashTable<I, ClusteringTraits<I>> table;
+    std::set<I> expected;
+
+    for (I i = 0; i < 3000; ++i) {
+        table.insert(i * 5);
+        expected.insert(i * 5);
+        if (i % 3 == 0) {
+            table.remove((i / 2) * 5);
+            expected.erase((i / 2) * 5);
+        }
+    }
+    REQUIRE(table.size() == expected.size());
+
+    std::vector<I> keys;
+    // some just past the ends of the range, wrapping around if unsigned
+    for (long long key = -20; key < 15100; ++key) {
+        keys.push_back(static_cast<I>(key));
+    }
+    std::vector<typename decltype(table)::Iterator> found(keys.size());
+    table.find_batch(keys.data(), keys.size(), found.data());
+
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        auto key = keys[i];
+        auto it = table.find(key);
+        // the plain probe loop, as a reference
+        REQUIRE(it == table.find(table.hash_of(key),
+                                 [key](I v) { return v == key; }));
+        REQUIRE(found[i] == it);
+        REQUIRE((it != table.end()) == (expected.count(key) == 1));
+        if (it != table.end()) REQUIRE(*it == key);
+    }
+}
+
+TEST_CASE("Integer probes") {
+    check_integer_probes<std::uint32_t>();
+    check_integer_probes<std::int64_t>();
+
+    // a small table where every key hashes to the last bucket, so that
+    // probes wrap around
+    HashTable<std::uint64_t, ClusteringTraits<std::uint64_t>> table(7);
+    for (std::uint64_t i = 0; i < 4; ++i) table.insert(1000 + i);
+    REQUIRE(table.capacity() == 7u);
+    for (std::uint64_t i = 0; i < 4; ++i) REQUIRE(table.contains(1000 + i));
+    REQUIRE_FALSE(table.contains(999));
+    REQUIRE_FALSE(table.contains(0));
+}
+
+TEST_CASE("Sparse iteration") {
+    StringTable strings;
+    for (int i = 0; i < 1000; ++i) {
+        strings.insert(std::to_string(i));
+    }
+
+    // leave a handful of entries spread over a big, mostly empty table
+    for (int i = 0; i < 1000; ++i) {
+        if (i % 97 != 0) REQUIRE(strings.remove(std::to_string(i)));
+    }
+    REQUIRE(strings.size() == 11u);
+
+    std::vector<std::string> seen;
+    for (const auto& value : strings) {
+        seen.push_back(value);
+    }
+    std::sort(seen.begin(), seen.end(), [](auto& a, auto& b) {
+        return std::stoi(a) < std::stoi(b);
+    });
+    REQUIRE(seen.size() == 11u);
+    for (size_t i = 0; i < seen.size(); ++i) {
+        REQUIRE(seen[i] == std::to_string(i * 97));
+    }
+
+    // begin() follows the first entry as entries come and go
+    while (!strings.empty()) {
+        auto first = *strings.begin();
+        REQUIRE(strings.remove(first));
+        REQUIRE(strings.find(first) == strings.end());
+    }
+    REQUIRE(strings.begin() == strings.end());
+
+    REQUIRE(strings.insert("again") == HashTableResult::InsertedNewEntry);
+    REQUIRE(*strings.begin() == "again");
+    auto it = strings.begin();
+    ++it;
+    REQUIRE(it == strings.end());
+
+    // iterators follow the buckets when the table itself moves
+    strings.insert("more");
+    it = strings.begin();
+    StringTable moved(std::move(strings));
+    std::set<std::string> rest;
+    for (; it != moved.end(); ++it) rest.insert(*it);
+    REQUIRE(rest == std::set<std::string>{"again", "more"});
+}
+
+TEST_CASE("Snapshot") {
+    struct TraitsForInt {
+        static unsigned hash(const int& val) { return std::hash<int>{}(val); }
+        static bool equals(const int& a, const int& b) { return a == b; }
+    };
+    using IntTable = HashTable<int, TraitsForInt>;
+
+    IntTable table;
+    for (int i = 0; i < 1000; ++i) {
+        table.insert(i);
+    }
+    for (int i = 0; i < 1000; i += 3) {
+        REQUIRE(table.remove(i));
+    }
+
+    std::stringstream stream;
+    REQUIRE(table.save(stream));
+
+    IntTable loaded{-1};
+    REQUIRE(loaded.load(stream));
+    REQUIRE(loaded.size() == table.size());
+    REQUIRE(loaded.capacity() == table.capacity());
+    for (int i = 0; i < 1000; ++i) {
+        REQUIRE(loaded.contains(i) == (i % 3 != 0));
+    }
+    REQUIRE_FALSE(loaded.contains(-1));
+
+    // still a working table after loading
+    REQUIRE(loaded.insert(0) == HashTableResult::InsertedNewEntry);
+    REQUIRE(loaded.remove(1));
+
+    std::stringstream truncated(stream.str().substr(0, 100));
+    REQUIRE_FALSE(loaded.load(truncated));
+    REQUIRE(loaded.size() == table.size());
+}
+
+TEST_CASE("Corrupt snapshots") {
+    HashTable<std::uint64_t> table;
+    for (std::uint64_t i = 0; i < 1000; ++i) table.insert(i);
+    for (std::uint64_t i = 0; i < 1000; i += 4) table.remove(i);
+
+    std::stringstream stream;
+    REQUIRE(table.save(stream));
+    const auto image = stream.str();
+
+    auto load = [](const std::string& bytes) {
+        HashTable<std::uint64_t> loaded;
+        loaded.insert(42);
+        std::stringstream in(bytes);
+        bool ok = loaded.load(in);
+        // a failed load leaves the table as it was
+        if (!ok) REQUIRE((loaded.size() == 1u && loaded.contains(42)));
+        return ok;
+    };
+    auto with_field = [&](std::size_t offset, std::uint64_t value) {
+        auto bytes = image;
+        std::memcpy(&bytes[offset], &value, sizeof(value));
+        return bytes;
+    };
+    using hashfu::SnapshotHeader;
+
+    REQUIRE(load(image));
+    REQUIRE_FALSE(load(image.substr(0, image.size() - 1)));
+    REQUIRE_FALSE(load(with_field(offsetof(SnapshotHeader, size), 751)));
+    REQUIRE_FALSE(
+        load(with_field(offsetof(SnapshotHeader, deleted_count), 0)));
+    REQUIRE_FALSE(load(with_field(offsetof(SnapshotHeader, capacity), 0)));
+    // no room left for a probe to end at an empty bucket
+    REQUIRE_FALSE(load(with_field(offsetof(SnapshotHeader, size),
+                                  table.capacity())));
+
+    // the occupancy bitmap comes last; clear a bit of a used bucket
+    auto bytes = image;
+    auto bitmap = bytes.size() - (table.capacity() / 64 + 1) * 8;
+    bool flipped = false;
+    for (std::size_t i = bitmap; i < bytes.size() && !flipped; ++i) {
+        if (bytes[i]) {
+            bytes[i] = static_cast<char>(bytes[i] & (bytes[i] - 1));
+            flipped = true;
+        }
+    }
+    REQUIRE(flipped);
+    REQUIRE_FALSE(load(bytes));
+
+    // a set bit past the sentinel
+    bytes = image;
+    bytes.back() = static_cast<char>(0x80);
+    REQUIRE_FALSE(load(bytes));
+
+    // a bucket flag that is no bool
+    bytes = image;
+    bytes[sizeof(SnapshotHeader) + 1] = 7;
+    REQUIRE_FALSE(load(bytes));
+}
+
+TEST_CASE("Snapshot of a seeded table") {
+    LeakedSeedTraits::leaked_seed = 0;
+    HashTable<std::uint64_t, LeakedSeedTraits> table;
+    for (std::uint64_t i = 0; i < 1000; ++i) table.insert(i * 7);
+    for (std::uint64_t i = 0; i < 1000; i += 2) table.remove(i * 7);
+
+    std::stringstream stream;
+    REQUIRE(table.save(stream));
+
+    // the loaded table takes over the seed, so the buckets are reused as
+    // they are, tombstones included, instead of being rehashed
+    HashTable<std::uint64_t, LeakedSeedTraits> loaded;
+    REQUIRE(loaded.seed() != table.seed());
+    REQUIRE(loaded.load(stream));
+    REQUIRE(loaded.seed() == table.seed());
+    REQUIRE(loaded.load_factor() == table.load_factor());
+    for (std::uint64_t i = 0; i < 1000; ++i) {
+        REQUIRE(loaded.contains(i * 7) == (i % 2 == 1));
+    }
+}
+
+TEST_CASE("Snapshot with serializer") {
+    struct StringSerializer {
+        static void write(std::ostream& os, const std::string& value) {
+            auto size = value.size();
+            os.write(reinterpret_cast<const char*>(&size), sizeof(size));
+            os.write(value.data(), static_cast<std::streamsize>(size));
+        }
+        static void read(std::istream& is, std::string& value) {
+            size_t size = 0;
+            is.read(reinterpret_cast<char*>(&size), sizeof(size));
+            value.resize(size);
+            is.read(value.data(), static_cast<std::streamsize>(size));
+        }
+    };
+
+    StringTable strings;
+    for (int i = 0; i < 500; ++i) {
+        strings.insert(std::to_string(i));
+    }
+    REQUIRE(strings.remove("42"));
+
+    std::stringstream stream;
+    REQUIRE(strings.save<StringSerializer>(stream));
+
+    StringTable loaded;
+    REQUIRE(loaded.load<StringSerializer>(stream));
+    REQUIRE(loaded.size() == 499u);
+    REQUIRE(loaded.capacity() == strings.capacity());
+    for (int i = 0; i < 500; ++i) {
+        REQUIRE(loaded.contains(std::to_string(i)) == (i != 42));
+    }
+
+    // a different hash function makes load() reinsert everything
+    struct OtherTraits {
+        static unsigned hash(const std::string& val) {
+            return TraitsForString::hash(val) * 7 + 1;
+        }
+        static bool equals(const std::string& a, const std::string& b) {
+            return a == b;
+        }
+    };
+    stream.clear();
+    stream.seekg(0);
+    HashTable<std::string, OtherTraits> rehashed;
+    REQUIRE(rehashed.load<StringSerializer>(stream));
+    REQUIRE(rehashed.size() == 499u);
+    for (int i = 0; i < 500; ++i) {
+        REQUIRE(rehashed.contains(std::to_string(i)) == (i != 42));
+    }
+}
@@ -0,0 +1,43 @@
+#include <set>
+
+#include "HopscotchHashTable.h"
+#include "catch.hpp"
+
+// The API tests shared with CuckooHashTable are in
+// displacingtable_tests.cpp.
+
+using hashfu::HopscotchHashTable;
+
+// Puts keys 0-23 in bucket 0, 24-47 in bucket 1 and so on, so that
+// neighborhoods overlap and inserts have to move entries to make room.
+struct CrowdedTraits {
+    static unsigned hash(const std::uint64_t& val) {
+        return static_cast<unsigned>(val / 24);
+    }
+    static bool equals(const std::uint64_t& a, const std::uint64_t& b) {
+        return a == b;
+    }
+};
+
+TEST_CASE("Crowded neighborhoods") {
+    HopscotchHashTable<std::uint64_t, CrowdedTraits> table;
+    std::set<std::uint64_t> expected;
+
+    for (std::uint64_t i = 0; i < 20000; ++i) {
+        auto key = (i * 7919) % 30011;
+        if (i % 3 == 2) {
+            REQUIRE(table.remove(key) == (expected.erase(key) == 1));
+        } else {
+            table.insert(key);
+            expected.insert(key);
+        }
+    }
+    REQUIRE(table.size() == expected.size());
+
+    std::set<std::uint64_t> iterated;
+    for (auto key : table) iterated.insert(key);
+    REQUIRE(iterated == expected);
+    for (std::uint64_t key = 0; key < 30011; ++key) {
+        REQUIRE(table.contains(key) == (expected.count(key) == 1));
+    }
+}
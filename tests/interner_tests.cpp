@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <cctype>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ConstexprHashMap.h"
+#include "Interner.h"
+#include "catch.hpp"
+
+using hashfu::StringViewTraits;
+
+using Interner = hashfu::Interner<StringViewTraits>;
+using ShardedInterner = hashfu::ShardedInterner<StringViewTraits, 4>;
+
+TEST_CASE("Construct") {
+    REQUIRE(Interner().empty());
+    REQUIRE(Interner().size() == 0u);
+    REQUIRE(ShardedInterner().size() == 0u);
+}
+
+TEST_CASE("Intern and look up") {
+    Interner interner;
+    auto a = interner.intern("example.com");
+    auto b = interner.intern("example.org");
+    REQUIRE(a == 0u);
+    REQUIRE(b == 1u);
+
+    std::string copy = "example.com";
+    REQUIRE(interner.intern(copy) == a);
+    REQUIRE(interner.intern("") == 2u);
+    REQUIRE(interner.size() == 3u);
+
+    REQUIRE(interner.lookup(a) == "example.com");
+    REQUIRE(interner.lookup(b) == "example.org");
+    REQUIRE(interner.lookup(2).empty());
+
+    REQUIRE(*interner.find("example.org") == b);
+    REQUIRE_FALSE(interner.find("example.net"));
+    REQUIRE(interner.size() == 3u);
+}
+
+TEST_CASE("Case-Insensitive") {
+    struct CaseInsensitiveTraits {
+        static unsigned hash(std::string_view val) {
+            std::string lower;
+            for (unsigned char c : val) lower += std::tolower(c);
+            return StringViewTraits::hash(lower);
+        }
+        static bool equals(std::string_view a, std::string_view b) {
+            if (a.size() != b.size()) return false;
+            for (std::size_t i = 0; i < a.size(); ++i) {
+                if (std::tolower(static_cast<unsigned char>(a[i])) !=
+                    std::tolower(static_cast<unsigned char>(b[i])))
+                    return false;
+            }
+            return true;
+        }
+    };
+
+    hashfu::Interner<CaseInsensitiveTraits> interner;
+    REQUIRE(interner.intern("Example.COM") == 0u);
+    REQUIRE(interner.intern("example.com") == 0u);
+    REQUIRE(*interner.find("EXAMPLE.com") == 0u);
+    REQUIRE(interner.lookup(0) == "Example.COM");
+    REQUIRE(interner.size() == 1u);
+}
+
+TEST_CASE("Views stay valid while interning") {
+    Interner interner;
+    auto first = interner.lookup(interner.intern("first"));
+
+    for (int i = 0; i < 10000; ++i) {
+        REQUIRE(interner.intern(std::to_string(i)) ==
+                static_cast<Interner::Id>(i + 1));
+    }
+    REQUIRE(first == "first");
+    for (int i = 0; i < 10000; ++i) {
+        REQUIRE(interner.lookup(static_cast<Interner::Id>(i + 1)) ==
+                std::to_string(i));
+    }
+
+    Interner moved = std::move(interner);
+    REQUIRE(*moved.find("9999") == 10000u);
+    REQUIRE(first == "first");
+}
+
+TEST_CASE("Sharded interner across threads") {
+    ShardedInterner interner;
+    constexpr int num_threads = 4;
+    constexpr int num_strings = 2000;
+
+    // every thread interns the same strings, in a different order
+    std::vector<std::vector<ShardedInterner::Id>> ids(
+        num_threads, std::vector<ShardedInterner::Id>(num_strings));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < num_strings; ++i) {
+                int n = (i * 7 + t * 13) % num_strings;
+                ids[t][n] = interner.intern("metric." + std::to_string(n));
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    REQUIRE(interner.size() == static_cast<std::size_t>(num_strings));
+    std::vector<ShardedInterner::Id> seen;
+    for (int n = 0; n < num_strings; ++n) {
+        for (int t = 1; t < num_threads; ++t) REQUIRE(ids[t][n] == ids[0][n]);
+        REQUIRE(interner.lookup(ids[0][n]) == "metric." + std::to_string(n));
+        REQUIRE(*interner.find("metric." + std::to_string(n)) == ids[0][n]);
+        seen.push_back(ids[0][n]);
+    }
+    std::sort(seen.begin(), seen.end());
+    REQUIRE(std::unique(seen.begin(), seen.end()) == seen.end());
+    REQUIRE_FALSE(interner.find("metric.-1"));
+}
+
+TEST_CASE("Seeded interners") {
+    using Seeded = hashfu::DefaultTraits<std::string_view>;
+    hashfu::Interner<Seeded> a, b;
+    REQUIRE(a.seed() != b.seed());
+    REQUIRE(a.hash_of("example.com") == Seeded::hash("example.com", a.seed()));
+    REQUIRE(a.intern("example.com") == 0u);
+    REQUIRE(*a.find("example.com") == 0u);
+
+    hashfu::Interner<Seeded> shared(a.seed());
+    REQUIRE(shared.hash_of("example.com") == a.hash_of("example.com"));
+
+    // every shard hashes with one seed, or find() would miss
+    hashfu::ShardedInterner<Seeded, 4> sharded;
+    std::vector<hashfu::Interner<Seeded>::Id> ids;
+    for (int i = 0; i < 1000; ++i) {
+        ids.push_back(sharded.intern("metric." + std::to_string(i)));
+    }
+    for (int i = 0; i < 1000; ++i) {
+        REQUIRE(*sharded.find("metric." + std::to_string(i)) == ids[i]);
+    }
+}
@@ -0,0 +1,107 @@
+#include "NodeHashMap.h"
+#include "catch.hpp"
+
+struct TraitsForInt {
+    static unsigned hash(const int& a) { return std::hash<int>{}(a); }
+    static bool equals(const int& a, const int& b) { return a == b; }
+};
+
+struct TraitsForString {
+    static unsigned hash(const std::string& val) {
+        return std::hash<std::string>{}(val);
+    }
+    static bool equals(const std::string& a, const std::string& b) {
+        return a == b;
+    }
+};
+
+using hashfu::HashTableResult;
+using hashfu::NodeHashMap;
+
+using IntTable = NodeHashMap<int, std::string, TraitsForInt>;
+using StringTable = NodeHashMap<std::string, int, TraitsForString>;
+
+TEST_CASE("Construct") {
+    REQUIRE(IntTable().empty());
+    REQUIRE(IntTable().size() == 0u);
+}
+
+TEST_CASE("Insert, find and remove") {
+    IntTable num_to_string;
+    REQUIRE(num_to_string.insert(1, "one") ==
+            HashTableResult::InsertedNewEntry);
+    REQUIRE(num_to_string.insert(2, "two") ==
+            HashTableResult::InsertedNewEntry);
+    REQUIRE(num_to_string.insert(2, "deux") ==
+            HashTableResult::ReplacedExistingEntry);
+    REQUIRE(num_to_string.size() == 2u);
+
+    REQUIRE(num_to_string.find(2)->value == "deux");
+    REQUIRE(num_to_string.contains(1));
+    REQUIRE_FALSE(num_to_string.contains(3));
+
+    REQUIRE(num_to_string.remove(1));
+    REQUIRE_FALSE(num_to_string.remove(1));
+    REQUIRE(num_to_string.size() == 1u);
+    REQUIRE(num_to_string.find(1) == num_to_string.end());
+}
+
+TEST_CASE("References survive growth") {
+    IntTable num_to_string;
+    num_to_string.insert(0, "zero");
+    auto& value = num_to_string.find(0)->value;
+    auto capacity = num_to_string.capacity();
+
+    for (int i = 1; i < 1000; ++i) {
+        num_to_string.insert(i, std::to_string(i));
+    }
+
+    REQUIRE(num_to_string.capacity() > capacity);
+    REQUIRE(&value == &num_to_string.find(0)->value);
+    REQUIRE(value == "zero");
+}
+
+TEST_CASE("Fuck ton of strings") {
+    StringTable strings;
+    for (int i = 0; i < 999; ++i) {
+        REQUIRE(strings.insert(std::to_string(i), i) ==
+                HashTableResult::InsertedNewEntry);
+    }
+
+    int count = 0;
+    for (const auto& node : strings) {
+        REQUIRE(std::stoi(node.key) == node.value);
+        ++count;
+    }
+    REQUIRE(count == 999);
+
+    // nodes freed by remove() are reused
+    for (int i = 0; i < 999; i += 2) {
+        REQUIRE(strings.remove(std::to_string(i)));
+    }
+    for (int i = 0; i < 999; i += 2) {
+        strings.insert(std::to_string(i), -i);
+    }
+    REQUIRE(strings.size() == 999u);
+    REQUIRE(strings.find("42")->value == -42);
+}
+
+TEST_CASE("Copy and move") {
+    StringTable counts;
+    for (const auto& word : {"this", "not", "this", "bye", "not", "this"}) {
+        ++counts[word];
+    }
+
+    StringTable copy = counts;
+    ++copy["this"];
+    REQUIRE(counts.find("this")->value == 3);
+    REQUIRE(copy.find("this")->value == 4);
+
+    StringTable moved = std::move(copy);
+    REQUIRE(moved.size() == 3u);
+    REQUIRE(moved.find("not")->value == 2);
+
+    moved.clear();
+    REQUIRE(moved.empty());
+    REQUIRE(moved.begin() == moved.end());
+}
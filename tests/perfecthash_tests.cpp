@@ -0,0 +1,103 @@
+#include "PerfectHash.h"
+#include "catch.hpp"
+
+struct TraitsForInt {
+    static unsigned hash(const int& val) { return std::hash<int>{}(val); }
+    static bool equals(const int& a, const int& b) { return a == b; }
+};
+
+struct TraitsForString {
+    static unsigned hash(const std::string& val) {
+        return std::hash<std::string>{}(val);
+    }
+    static bool equals(const std::string& a, const std::string& b) {
+        return a == b;
+    }
+};
+
+using hashfu::HashMap;
+using hashfu::MinimalPerfectHash;
+using hashfu::PerfectHashMap;
+
+TEST_CASE("Minimal and perfect") {
+    std::vector<std::string> keys;
+    for (int i = 0; i < 10000; ++i) {
+        keys.push_back("key" + std::to_string(i));
+    }
+
+    MinimalPerfectHash<std::string, TraitsForString> mph;
+    REQUIRE(mph.build(keys.begin(), keys.end()));
+    REQUIRE(mph.size() == keys.size());
+
+    std::vector<bool> seen(keys.size(), false);
+    for (const auto& key : keys) {
+        auto index = mph.index(key);
+        REQUIRE(index < keys.size());
+        REQUIRE_FALSE(seen[index]);
+        seen[index] = true;
+    }
+}
+
+TEST_CASE("Tiny key sets") {
+    MinimalPerfectHash<int, TraitsForInt> mph;
+    REQUIRE(mph.build_from_hashes({}));
+    REQUIRE(mph.empty());
+
+    const int one[] = {42};
+    REQUIRE(mph.build(std::begin(one), std::end(one)));
+    REQUIRE(mph.index(42) == 0u);
+
+    const int two[] = {1, 2};
+    REQUIRE(mph.build(std::begin(two), std::end(two)));
+    REQUIRE(mph.index(1) != mph.index(2));
+}
+
+TEST_CASE("Map lookups") {
+    HashMap<int, std::string, TraitsForInt> map;
+    for (int i = 0; i < 5000; ++i) {
+        map.insert(i * 3, std::to_string(i));
+    }
+
+    PerfectHashMap<int, std::string, TraitsForInt> perfect;
+    REQUIRE(perfect.build(map));
+    REQUIRE(perfect.size() == 5000u);
+
+    for (int i = 0; i < 15000; ++i) {
+        auto* value = perfect.find(i);
+        if (i % 3 == 0) {
+            REQUIRE(value);
+            REQUIRE(*value == std::to_string(i / 3));
+        } else {
+            REQUIRE_FALSE(value);
+        }
+    }
+}
+
+TEST_CASE("Colliding hashes") {
+    struct CollidingTraits {
+        static unsigned hash(const int& val) { return val % 100; }
+        static bool equals(const int& a, const int& b) { return a == b; }
+    };
+
+    HashMap<int, int, CollidingTraits> map;
+    for (int i = 0; i < 1000; ++i) {
+        map.insert(i, -i);
+    }
+
+    PerfectHashMap<int, int, CollidingTraits> perfect;
+    REQUIRE(perfect.build(map));
+    REQUIRE(perfect.size() == 1000u);
+    for (int i = 0; i < 1000; ++i) {
+        REQUIRE(*perfect.find(i) == -i);
+    }
+    REQUIRE_FALSE(perfect.contains(1000));
+    REQUIRE_FALSE(perfect.contains(-1));
+}
+
+TEST_CASE("Empty map") {
+    HashMap<int, int, TraitsForInt> map;
+    PerfectHashMap<int, int, TraitsForInt> perfect;
+    REQUIRE(perfect.build(map));
+    REQUIRE(perfect.empty());
+    REQUIRE_FALSE(perfect.contains(0));
+}
@@ -0,0 +1,215 @@
+#include <map>
+#include <type_traits>
+
+#include "SmallHashMap.h"
+#include "catch.hpp"
+
+struct TraitsForInt {
+    static constexpr bool bitwise_equals = true;
+
+    static unsigned hash(const int& a) { return std::hash<int>{}(a); }
+    static bool equals(const int& a, const int& b) { return a == b; }
+};
+
+struct TraitsForString {
+    static unsigned hash(const std::string& val) {
+        return std::hash<std::string>{}(val);
+    }
+    static bool equals(const std::string& a, const std::string& b) {
+        return a == b;
+    }
+};
+
+using hashfu::HashTableResult;
+using hashfu::SmallHashMap;
+
+using IntTable = SmallHashMap<int, std::string, TraitsForInt, 4>;
+using StringTable = SmallHashMap<std::string, int, TraitsForString, 4>;
+
+TEST_CASE("Construct") {
+    REQUIRE(IntTable().empty());
+    REQUIRE(IntTable().size() == 0u);
+    REQUIRE(IntTable().is_small());
+}
+
+TEST_CASE("Insert, find and remove") {
+    IntTable num_to_string;
+    REQUIRE(num_to_string.insert(1, "one") ==
+            HashTableResult::InsertedNewEntry);
+    REQUIRE(num_to_string.insert(2, "two") ==
+            HashTableResult::InsertedNewEntry);
+    REQUIRE(num_to_string.insert(2, "deux") ==
+            HashTableResult::ReplacedExistingEntry);
+    REQUIRE(num_to_string.size() == 2u);
+
+    REQUIRE(*num_to_string.find(2) == "deux");
+    REQUIRE(num_to_string.contains(1));
+    REQUIRE_FALSE(num_to_string.contains(3));
+
+    REQUIRE(num_to_string.remove(1));
+    REQUIRE_FALSE(num_to_string.remove(1));
+    REQUIRE(num_to_string.size() == 1u);
+    REQUIRE(num_to_string.find(1) == nullptr);
+    REQUIRE(*num_to_string.find(2) == "deux");
+}
+
+TEST_CASE("Promotes past the inline capacity") {
+    StringTable strings;
+    for (int i = 0; i < 4; ++i) strings.insert(std::to_string(i), i);
+    REQUIRE(strings.is_small());
+
+    strings.insert("4", 4);
+    REQUIRE_FALSE(strings.is_small());
+    REQUIRE(strings.size() == 5u);
+    for (int i = 0; i < 5; ++i) {
+        REQUIRE(*strings.find(std::to_string(i)) == i);
+    }
+
+    strings.clear();
+    REQUIRE(strings.is_small());
+    REQUIRE(strings.empty());
+}
+
+TEST_CASE("UUID keys") {
+    struct Uuid {
+        std::uint64_t high, low;
+    };
+    SmallHashMap<Uuid, int, hashfu::DefaultTraits<Uuid>, 8> ids;
+
+    // odd counts leave a key over after the wide compares
+    for (std::uint64_t i = 0; i < 7; ++i) ids.insert({i, ~i}, int(i));
+    REQUIRE(ids.is_small());
+    for (std::uint64_t i = 0; i < 7; ++i) REQUIRE(*ids.find({i, ~i}) == int(i));
+    REQUIRE(ids.find({0, 0}) == nullptr);
+    REQUIRE(ids.find({7, ~7ull}) == nullptr);
+
+    REQUIRE(ids.remove({3, ~3ull}));
+    REQUIRE(ids.find({3, ~3ull}) == nullptr);
+    REQUIRE(*ids.find({6, ~6ull}) == 6);
+
+    for (std::uint64_t i = 10; i < 20; ++i) ids.insert({i, ~i}, int(i));
+    REQUIRE_FALSE(ids.is_small());
+    REQUIRE(*ids.find({15, ~15ull}) == 15);
+    REQUIRE(*ids.find({6, ~6ull}) == 6);
+}
+
+template <typename K>
+static void check_vector_scan() {
+    // every count up to the inline capacity, so that the compares that
+    // cover several keys and the ones left over all find their key
+    SmallHashMap<K, int, hashfu::DefaultTraits<K>, 64> map;
+    for (int i = 0; i < 64; ++i) {
+        map.insert(static_cast<K>(i * 3 + 1), i);
+        for (int j = 0; j <= i; ++j) {
+            REQUIRE(*map.find(static_cast<K>(j * 3 + 1)) == j);
+        }
+        REQUIRE(map.find(static_cast<K>(0)) == nullptr);
+        REQUIRE(map.find(static_cast<K>(i * 3 + 2)) == nullptr);
+    }
+    REQUIRE(map.is_small());
+}
+
+TEST_CASE("Integer keys") {
+    check_vector_scan<std::uint8_t>();
+    check_vector_scan<std::int16_t>();
+    check_vector_scan<std::uint32_t>();
+    check_vector_scan<std::int64_t>();
+
+    // a difference in the top byte only
+    SmallHashMap<std::uint64_t, int> map;
+    map.insert(1, 1);
+    map.insert(1ull << 56 | 1, 2);
+    REQUIRE(*map.find(1) == 1);
+    REQUIRE(*map.find(1ull << 56 | 1) == 2);
+    REQUIRE(map.find(1ull << 57 | 1) == nullptr);
+}
+
+TEST_CASE("Iterators") {
+    IntTable map;
+    REQUIRE(map.begin() == map.end());
+
+    std::map<int, std::string> expected;
+    for (int i = 0; i < 6; ++i) {
+        map.insert(i, std::to_string(i));
+        expected[i] = std::to_string(i);
+
+        // inline, then from the HashMap once promoted
+        std::map<int, std::string> seen;
+        for (auto entry : map) seen[entry.key] = entry.value;
+        REQUIRE(seen == expected);
+    }
+    REQUIRE_FALSE(map.is_small());
+
+    for (auto it = map.begin(); it != map.end(); ++it) it->value += "!";
+    const auto& const_map = map;
+    int count = 0;
+    for (auto it = const_map.cbegin(); it != const_map.cend(); ++it) {
+        REQUIRE(it->value == std::to_string(it->key) + "!");
+        ++count;
+    }
+    REQUIRE(count == 6);
+}
+
+TEST_CASE("Moves are noexcept when the entries' are") {
+    static_assert(std::is_nothrow_move_constructible_v<IntTable>);
+    static_assert(std::is_nothrow_move_assignable_v<IntTable>);
+
+    struct ThrowingMove {
+        ThrowingMove() = default;
+        ThrowingMove(ThrowingMove&&) noexcept(false) {}
+        ThrowingMove(const ThrowingMove&) = default;
+        ThrowingMove& operator=(const ThrowingMove&) = default;
+    };
+    using Throwing = SmallHashMap<int, ThrowingMove, TraitsForInt, 4>;
+    static_assert(!std::is_nothrow_move_constructible_v<Throwing>);
+    static_assert(!std::is_nothrow_move_assignable_v<Throwing>);
+}
+
+TEST_CASE("Fuck ton of strings") {
+    StringTable strings;
+    for (int i = 0; i < 999; ++i) {
+        REQUIRE(strings.insert(std::to_string(i), i) ==
+                HashTableResult::InsertedNewEntry);
+    }
+
+    int count = 0;
+    strings.for_each([&](const std::string& key, int& value) {
+        REQUIRE(std::stoi(key) == value);
+        ++count;
+    });
+    REQUIRE(count == 999);
+
+    for (int i = 0; i < 999; i += 2) {
+        REQUIRE(strings.remove(std::to_string(i)));
+    }
+    REQUIRE(strings.size() == 499u);
+    REQUIRE(*strings.find("43") == 43);
+}
+
+TEST_CASE("Copy and move") {
+    StringTable counts;
+    for (const auto& word : {"this", "not", "this", "bye", "not", "this"}) {
+        ++counts[word];
+    }
+    REQUIRE(counts.is_small());
+
+    StringTable copy = counts;
+    ++copy["this"];
+    REQUIRE(*counts.find("this") == 3);
+    REQUIRE(*copy.find("this") == 4);
+
+    StringTable moved = std::move(copy);
+    REQUIRE(moved.size() == 3u);
+    REQUIRE(*moved.find("not") == 2);
+    REQUIRE(copy.empty());
+
+    for (int i = 0; i < 10; ++i) moved[std::to_string(i)] = i;
+    swap(moved, counts);
+    REQUIRE(counts.size() == 13u);
+    REQUIRE(*counts.find("7") == 7);
+    REQUIRE(moved.size() == 3u);
+    REQUIRE(moved.is_small());
+
+    moved.clear();
+    REQUIRE(moved.empty());
+}
@@ -0,0 +1,147 @@
+#include <cstdint>
+
+#include "SoAHashMap.h"
+#include "catch.hpp"
+
+struct TraitsForInt {
+    static unsigned hash(const int& a) { return std::hash<int>{}(a); }
+    static bool equals(const int& a, const int& b) { return a == b; }
+};
+
+struct TraitsForString {
+    static unsigned hash(const std::string& val) {
+        return std::hash<std::string>{}(val);
+    }
+    static bool equals(const std::string& a, const std::string& b) {
+        return a == b;
+    }
+};
+
+using hashfu::HashTableResult;
+using hashfu::SoAHashMap;
+
+using IntTable = SoAHashMap<int, std::string, TraitsForInt>;
+using StringTable = SoAHashMap<std::string, int, TraitsForString>;
+
+TEST_CASE("Construct") {
+    REQUIRE(IntTable().empty());
+    REQUIRE(IntTable().size() == 0u);
+}
+
+TEST_CASE("Insert, find and remove") {
+    IntTable num_to_string;
+    REQUIRE(num_to_string.insert(1, "one") ==
+            HashTableResult::InsertedNewEntry);
+    REQUIRE(num_to_string.insert(2, "two") ==
+            HashTableResult::InsertedNewEntry);
+    REQUIRE(num_to_string.insert(2, "deux") ==
+            HashTableResult::ReplacedExistingEntry);
+    REQUIRE(num_to_string.size() == 2u);
+
+    REQUIRE(num_to_string.find(2)->value == "deux");
+    REQUIRE(num_to_string.contains(1));
+    REQUIRE_FALSE(num_to_string.contains(3));
+
+    REQUIRE(num_to_string.remove(1));
+    REQUIRE_FALSE(num_to_string.remove(1));
+    REQUIRE(num_to_string.size() == 1u);
+    REQUIRE(num_to_string.find(1) == num_to_string.end());
+}
+
+TEST_CASE("Large values") {
+    struct Big {
+        int id;
+        char padding[252];
+    };
+    SoAHashMap<int, Big, TraitsForInt> big;
+    for (int i = 0; i < 1000; ++i) big.insert(i, Big{i, {}});
+
+    REQUIRE(big.size() == 1000u);
+    for (int i = 0; i < 1000; ++i) REQUIRE(big.find(i)->value.id == i);
+
+    int count = 0;
+    for (auto entry : big) {
+        REQUIRE(entry.key == entry.value.id);
+        ++count;
+    }
+    REQUIRE(count == 1000);
+}
+
+TEST_CASE("Over-aligned values") {
+    struct alignas(128) Wide {
+        int id;
+    };
+    SoAHashMap<int, Wide, TraitsForInt> wide;
+    for (int i = 0; i < 1000; ++i) wide.insert(i, Wide{i});
+
+    for (int i = 0; i < 1000; ++i) {
+        auto& value = wide[i];
+        REQUIRE(reinterpret_cast<std::uintptr_t>(&value) % alignof(Wide) ==
+                0u);
+        REQUIRE(value.id == i);
+    }
+}
+
+TEST_CASE("Removed slots are reused") {
+    IntTable num_to_string;
+    for (int i = 0; i < 100; ++i) {
+        num_to_string.insert(i, std::to_string(i));
+    }
+    auto capacity = num_to_string.capacity();
+
+    for (int round = 0; round < 100; ++round) {
+        REQUIRE(num_to_string.remove(round));
+        REQUIRE(num_to_string.insert(round, "again") ==
+                HashTableResult::InsertedNewEntry);
+    }
+    REQUIRE(num_to_string.capacity() == capacity);
+    REQUIRE(num_to_string.size() == 100u);
+    REQUIRE(num_to_string.find(42)->value == "again");
+
+    num_to_string.find(7)->value = "seven";
+    REQUIRE(num_to_string[7] == "seven");
+}
+
+TEST_CASE("Fuck ton of strings") {
+    StringTable strings;
+    for (int i = 0; i < 999; ++i) {
+        REQUIRE(strings.insert(std::to_string(i), i) ==
+                HashTableResult::InsertedNewEntry);
+    }
+
+    int count = 0;
+    for (const auto& entry : strings) {
+        REQUIRE(std::stoi(entry.key) == entry.value);
+        ++count;
+    }
+    REQUIRE(count == 999);
+
+    for (int i = 0; i < 999; i += 2) {
+        REQUIRE(strings.remove(std::to_string(i)));
+    }
+    for (int i = 0; i < 999; i += 2) {
+        strings.insert(std::to_string(i), -i);
+    }
+    REQUIRE(strings.size() == 999u);
+    REQUIRE(strings.find("42")->value == -42);
+}
+
+TEST_CASE("Copy and move") {
+    StringTable counts;
+    for (const auto& word : {"this", "not", "this", "bye", "not", "this"}) {
+        ++counts[word];
+    }
+
+    StringTable copy = counts;
+    ++copy["this"];
+    REQUIRE(counts.find("this")->value == 3);
+    REQUIRE(copy.find("this")->value == 4);
+
+    StringTable moved = std::move(copy);
+    REQUIRE(moved.size() == 3u);
+    REQUIRE(moved.find("not")->value == 2);
+
+    moved.clear();
+    REQUIRE(moved.empty());
+    REQUIRE(moved.begin() == moved.end());
+}
@@ -0,0 +1,136 @@
+#include <random>
+
+#include "StaticHashMap.h"
+#include "catch.hpp"
+
+struct TraitsForInt {
+    static unsigned hash(const int& a) { return std::hash<int>{}(a); }
+    static bool equals(const int& a, const int& b) { return a == b; }
+};
+
+// Sends every key to the same home slot and counts the comparisons made.
+struct CollidingTraits {
+    static inline int compares = 0;
+
+    static unsigned hash(const int&) { return 3; }
+    static bool equals(const int& a, const int& b) {
+        ++compares;
+        return a == b;
+    }
+};
+
+using hashfu::HashTableResult;
+using hashfu::StaticHashMap;
+
+using IntTable = StaticHashMap<int, std::string, TraitsForInt, 16>;
+
+TEST_CASE("Construct") {
+    REQUIRE(IntTable().empty());
+    REQUIRE(IntTable().size() == 0u);
+    REQUIRE(IntTable::capacity() == 16u);
+}
+
+TEST_CASE("Insert, find and remove") {
+    IntTable num_to_string;
+    REQUIRE(num_to_string.try_insert(1, "one") ==
+            HashTableResult::InsertedNewEntry);
+    REQUIRE(num_to_string.try_insert(2, "two") ==
+            HashTableResult::InsertedNewEntry);
+    REQUIRE(num_to_string.try_insert(2, "deux") ==
+            HashTableResult::ReplacedExistingEntry);
+    REQUIRE(num_to_string.size() == 2u);
+
+    REQUIRE(*num_to_string.find(2) == "deux");
+    REQUIRE(num_to_string.contains(1));
+    REQUIRE_FALSE(num_to_string.contains(3));
+
+    REQUIRE(num_to_string.remove(1));
+    REQUIRE_FALSE(num_to_string.remove(1));
+    REQUIRE(num_to_string.size() == 1u);
+    REQUIRE(num_to_string.find(1) == nullptr);
+
+    IntTable copy = num_to_string;
+    num_to_string.clear();
+    REQUIRE(num_to_string.empty());
+    REQUIRE(*copy.find(2) == "deux");
+}
+
+TEST_CASE("Full table refuses inserts") {
+    IntTable num_to_string;
+    for (int i = 0; i < 16; ++i) {
+        REQUIRE(num_to_string.try_insert(i, std::to_string(i)) ==
+                HashTableResult::InsertedNewEntry);
+    }
+
+    REQUIRE(num_to_string.try_insert(16, "sixteen") ==
+            HashTableResult::TableFull);
+    REQUIRE(num_to_string.size() == 16u);
+    REQUIRE_FALSE(num_to_string.contains(16));
+
+    // replacing still works when full
+    REQUIRE(num_to_string.try_insert(7, "seven") ==
+            HashTableResult::ReplacedExistingEntry);
+    REQUIRE(*num_to_string.find(7) == "seven");
+}
+
+TEST_CASE("Probes are bounded by MaxProbe") {
+    using Colliding = StaticHashMap<int, int, CollidingTraits, 64, 8>;
+    Colliding map;
+
+    for (int i = 0; i < 8; ++i) {
+        REQUIRE(map.try_insert(i, i) == HashTableResult::InsertedNewEntry);
+    }
+    CollidingTraits::compares = 0;
+    REQUIRE(map.try_insert(8, 8) == HashTableResult::TableFull);
+    REQUIRE(CollidingTraits::compares == 8);
+
+    CollidingTraits::compares = 0;
+    REQUIRE_FALSE(map.contains(100));
+    REQUIRE(CollidingTraits::compares <=
+            static_cast<int>(Colliding::max_probe_length()));
+
+    // the slot freed by a removal in the middle of the run is reused
+    REQUIRE(map.remove(3));
+    REQUIRE(map.try_insert(8, 8) == HashTableResult::InsertedNewEntry);
+    for (int i = 0; i <= 8; ++i) REQUIRE(map.contains(i) == (i != 3));
+}
+
+TEST_CASE("Random inserts and removes") {
+    using Map = StaticHashMap<int, int, TraitsForInt, 1024, 16>;
+    Map map;
+    std::vector<bool> present(4096, false);
+    std::mt19937 rng(7);
+
+    for (int round = 0; round < 100000; ++round) {
+        int key = static_cast<int>(rng() % present.size());
+        if (rng() % 2) {
+            auto result = map.try_insert(key, key * 2);
+            if (result == HashTableResult::InsertedNewEntry) {
+                present[key] = true;
+            }
+            if (result == HashTableResult::TableFull) {
+                REQUIRE_FALSE(present[key]);
+            }
+        } else {
+            REQUIRE(map.remove(key) == present[key]);
+            present[key] = false;
+        }
+    }
+
+    std::size_t count = 0;
+    for (std::size_t key = 0; key < present.size(); ++key) {
+        int k = static_cast<int>(key);
+        REQUIRE(map.contains(k) == present[key]);
+        if (present[key]) REQUIRE(*map.find(k) == k * 2);
+        count += present[key];
+    }
+    REQUIRE(count == map.size());
+    REQUIRE(count <= Map::capacity());
+
+    std::size_t visited = 0;
+    map.for_each([&](const int& key, int& value) {
+        REQUIRE(value == key * 2);
+        ++visited;
+    });
+    REQUIRE(visited == count);
+}
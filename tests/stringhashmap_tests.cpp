@@ -0,0 +1,158 @@
+#include <cctype>
+#include <string>
+
+#include "ConstexprHashMap.h"
+#include "StringHashMap.h"
+#include "catch.hpp"
+
+using hashfu::Arena;
+using hashfu::HashTableResult;
+using hashfu::StringHashMap;
+using hashfu::StringViewTraits;
+
+using StringTable = StringHashMap<int, StringViewTraits>;
+
+TEST_CASE("Construct") {
+    REQUIRE(StringTable().empty());
+    REQUIRE(StringTable().size() == 0u);
+    REQUIRE(StringTable().key_bytes_reserved() == 0u);
+}
+
+TEST_CASE("Insert, find and remove") {
+    StringTable table;
+    REQUIRE(table.insert("one", 1) == HashTableResult::InsertedNewEntry);
+    REQUIRE(table.insert("two", 2) == HashTableResult::InsertedNewEntry);
+    REQUIRE(table.insert("two", 22) == HashTableResult::ReplacedExistingEntry);
+    REQUIRE(table.insert("", 0) == HashTableResult::InsertedNewEntry);
+    REQUIRE(table.size() == 3u);
+
+    std::string key = "two";
+    REQUIRE(table.find(key)->value == 22);
+    REQUIRE(table.find(std::string_view("two, three").substr(0, 3))->value ==
+            22);
+    REQUIRE(table.contains(""));
+    REQUIRE_FALSE(table.contains("three"));
+
+    REQUIRE(table.remove("one"));
+    REQUIRE_FALSE(table.remove("one"));
+    REQUIRE(table.size() == 2u);
+    REQUIRE(table.find("one") == table.end());
+}
+
+TEST_CASE("Case-Insensitive") {
+    struct CaseInsensitiveTraits {
+        static unsigned hash(std::string_view val) {
+            std::string lower;
+            for (unsigned char c : val) lower += std::tolower(c);
+            return StringViewTraits::hash(lower);
+        }
+        static bool equals(std::string_view a, std::string_view b) {
+            if (a.size() != b.size()) return false;
+            for (std::size_t i = 0; i < a.size(); ++i) {
+                if (std::tolower(static_cast<unsigned char>(a[i])) !=
+                    std::tolower(static_cast<unsigned char>(b[i])))
+                    return false;
+            }
+            return true;
+        }
+    };
+
+    StringHashMap<int, CaseInsensitiveTraits> table;
+    REQUIRE(table.insert("HelloWorld", 1) ==
+            HashTableResult::InsertedNewEntry);
+    REQUIRE(table.insert("helloworld", 2) ==
+            HashTableResult::ReplacedExistingEntry);
+    REQUIRE(table.size() == 1u);
+    REQUIRE(table.find("HELLOWORLD")->value == 2);
+    REQUIRE(table.begin()->key() == "HelloWorld");
+    REQUIRE(table.remove("HELLOworld"));
+    REQUIRE(table.empty());
+}
+
+TEST_CASE("Keys are copied into the arena") {
+    StringTable table;
+    {
+        std::string key(100, 'x');
+        table.insert(key, 1);
+        key.assign(100, 'y');
+    }
+    REQUIRE(table.contains(std::string(100, 'x')));
+    REQUIRE(table.begin()->key() == std::string(100, 'x'));
+    REQUIRE(table.key_bytes_reserved() > 0u);
+
+    table.clear();
+    REQUIRE(table.empty());
+    REQUIRE(table.key_bytes_reserved() == 0u);
+}
+
+TEST_CASE("Fuck ton of strings") {
+    StringTable strings;
+    for (int i = 0; i < 999; ++i) {
+        REQUIRE(strings.insert(std::to_string(i), i) ==
+                HashTableResult::InsertedNewEntry);
+    }
+
+    int count = 0;
+    for (const auto& entry : strings) {
+        REQUIRE(std::stoi(std::string(entry.key())) == entry.value);
+        ++count;
+    }
+    REQUIRE(count == 999);
+
+    for (int i = 0; i < 999; i += 2) {
+        REQUIRE(strings.remove(std::to_string(i)));
+    }
+    REQUIRE(strings.size() == 499u);
+    REQUIRE(strings.find("43")->value == 43);
+}
+
+TEST_CASE("Copy and move") {
+    StringTable counts;
+    for (const auto& word : {"this", "not", "this", "bye", "not", "this"}) {
+        ++counts[word];
+    }
+
+    StringTable copy = counts;
+    ++copy["this"];
+    REQUIRE(counts.find("this")->value == 3);
+    REQUIRE(copy.find("this")->value == 4);
+
+    StringTable moved = std::move(copy);
+    REQUIRE(moved.size() == 3u);
+    REQUIRE(moved.find("not")->value == 2);
+
+    moved.clear();
+    REQUIRE(moved.empty());
+    REQUIRE(moved.begin() == moved.end());
+}
+
+TEST_CASE("Arena") {
+    Arena arena;
+    auto* a = static_cast<char*>(arena.allocate(3, 1));
+    auto* b = arena.allocate(8, 8);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(b) % 8 == 0u);
+    REQUIRE(static_cast<char*>(b) >= a + 3);
+
+    // larger than a quarter block: gets its own block
+    auto* big = arena.allocate(1 << 20, 1);
+    std::memset(big, 0, 1 << 20);
+    REQUIRE(arena.bytes_reserved() >= (1u << 20));
+
+    auto view = arena.copy("hello");
+    REQUIRE(view == "hello");
+    REQUIRE(arena.copy("").empty());
+}
+
+TEST_CASE("Seeded traits") {
+    StringHashMap<int> map;
+    for (int i = 0; i < 1000; ++i) map.insert(std::to_string(i), i);
+
+    // copies hash with their own seed, moves keep the old one
+    auto copy = map;
+    auto moved = std::move(map);
+    for (int i = 0; i < 1000; ++i) {
+        REQUIRE(copy.find(std::to_string(i))->value == i);
+        REQUIRE(moved.find(std::to_string(i))->value == i);
+    }
+    REQUIRE_FALSE(moved.contains("1000"));
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "DefaultTraits.h"
+
+// Traits shared by the table tests.
+
+struct TraitsForString {
+    static unsigned hash(const std::string& val) {
+        return std::hash<std::string>{}(val);
+    }
+    static bool equals(const std::string& a, const std::string& b) {
+        return a == b;
+    }
+};
+
+// Seeded traits that collide completely under one chosen seed, as if an
+// attacker had learned it.
+struct LeakedSeedTraits {
+    static inline std::uint64_t leaked_seed = 0;
+
+    static unsigned hash(const std::uint64_t& val) {
+        return hashfu::DefaultTraits<std::uint64_t>::hash(val);
+    }
+    static unsigned hash(const std::uint64_t& val, std::uint64_t seed) {
+        if (seed == leaked_seed) return 0;
+        return hashfu::DefaultTraits<std::uint64_t>::hash(val ^ seed);
+    }
+    static bool equals(const std::uint64_t& a, const std::uint64_t& b) {
+        return a == b;
+    }
+};
@@ -0,0 +1,128 @@
+/* Reports how well a hash spreads a key sample over HashTable's buckets;
+ * see HashAnalyzer.h.
+ *
+ *   hash_analyzer [--traits NAME] [--count N] (--file PATH | --gen KIND)
+ *
+ * --file reads one string key per line. --gen makes N keys of a kind:
+ * sequential, strided or random integers, or words ("item-<i>"). --traits
+ * picks the hash: default (DefaultTraits), accelerated (AcceleratedTraits)
+ * or identity (the integer itself, the byte sum for strings), the last
+ * being there to show what a bad hash looks like.
+ *
+ * To analyze traits of your own, call hashfu::analyze_hash<YourTraits>()
+ * on your keys the same way run() does below.
+ *
+ * Exits with 1 if any check fails, so it can gate a build.
+ */
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "HashAnalyzer.h"
+#include "HashKernels.h"
+
+struct IdentityTraits {
+    static unsigned hash(const std::uint64_t& key) {
+        return static_cast<unsigned>(key);
+    }
+    static unsigned hash(const std::string& key) {
+        unsigned sum = 0;
+        for (unsigned char c : key) sum += c;
+        return sum;
+    }
+    template <typename K>
+    static bool equals(const K& a, const K& b) {
+        return a == b;
+    }
+};
+
+template <typename K>
+static int run(const std::string& traits, const std::vector<K>& keys) {
+    hashfu::HashReport report;
+    if (traits == "default") {
+        report = hashfu::analyze_hash<hashfu::DefaultTraits<K>>(keys);
+    } else if (traits == "accelerated") {
+        report = hashfu::analyze_hash<hashfu::AcceleratedTraits<K>>(keys);
+    } else if (traits == "identity") {
+        report = hashfu::analyze_hash<IdentityTraits>(keys);
+    } else {
+        std::cerr << "unknown traits: " << traits << "\n";
+        return 2;
+    }
+
+    report.print(std::cout);
+    return report.ok() ? 0 : 1;
+}
+
+static int usage() {
+    std::cerr << "usage: hash_analyzer [--traits default|accelerated|"
+                 "identity] [--count N]\n"
+                 "                     (--file PATH | --gen sequential|"
+                 "strided|random|words)\n";
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    std::string traits = "default", file, gen;
+    std::size_t count = 100000;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!std::strcmp(argv[i], "--traits")) {
+            traits = argv[i + 1];
+        } else if (!std::strcmp(argv[i], "--count")) {
+            count = std::strtoull(argv[i + 1], nullptr, 10);
+        } else if (!std::strcmp(argv[i], "--file")) {
+            file = argv[i + 1];
+        } else if (!std::strcmp(argv[i], "--gen")) {
+            gen = argv[i + 1];
+        } else {
+            return usage();
+        }
+    }
+    if (argc % 2 == 0 || file.empty() == gen.empty()) return usage();
+
+    if (!file.empty()) {
+        std::ifstream in(file);
+        if (!in) {
+            std::cerr << "cannot open " << file << "\n";
+            return 2;
+        }
+
+        // the analysis wants distinct keys
+        std::set<std::string> seen;
+        std::vector<std::string> keys;
+        for (std::string line; std::getline(in, line);) {
+            if (seen.insert(line).second) keys.push_back(line);
+        }
+        return run(traits, keys);
+    }
+
+    if (gen == "words") {
+        std::vector<std::string> keys;
+        for (std::size_t i = 0; i < count; ++i) {
+            keys.push_back("item-" + std::to_string(i));
+        }
+        return run(traits, keys);
+    }
+
+    std::vector<std::uint64_t> keys(count);
+    std::mt19937_64 rng(42);
+    for (std::size_t i = 0; i < count; ++i) {
+        if (gen == "sequential") {
+            keys[i] = i;
+        } else if (gen == "strided") {
+            keys[i] = i << 8;
+        } else if (gen == "random") {
+            keys[i] = rng();
+        } else {
+            return usage();
+        }
+    }
+    return run(traits, keys);
+}